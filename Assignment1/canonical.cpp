@@ -0,0 +1,229 @@
+//
+// Canonical form of Sudoku puzzles and a cache of their solutions
+//
+
+/*
+ * Two puzzles are equivalent if one turns into the other by transposing
+ * the grid, permuting the bands (groups of k rows), the rows within a
+ * band, the stacks (groups of k columns) and the columns within a stack,
+ * and relabeling the digits. Equivalent puzzles have equivalent
+ * solutions.
+ *
+ * The canonical form is the lexicographically smallest grid over all of
+ * these, with digits relabeled in order of first appearance (blanks are
+ * 0 and stay 0). All row and column orders are tried for order 3; a
+ * candidate is dropped at the first cell where it exceeds the best one
+ * so far, which happens after a few cells almost always. For larger
+ * orders the group is too big to search, so only transposition and
+ * relabeling are taken into account.
+ */
+
+#ifndef ASSIGNMENT1_CANONICAL
+#define ASSIGNMENT1_CANONICAL
+
+#include <map>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+
+class Canonical {
+protected:
+    // Order of the puzzle
+    int k;
+    // Number of values (and cells per unit)
+    int size;
+    // Whether the grid is transposed first
+    bool transpose;
+    // Line of the (transposed) grid at every row and column
+    std::vector<int> rows, cols;
+    // Canonical digit of every original digit (0 stays 0)
+    std::vector<int> label;
+
+    // All line orders that keep bands together
+    static std::vector<std::vector<int> > orders(int k) {
+        std::vector<std::vector<int> > o(1);
+        if (k > 3) {
+            for (int i = 0; i < k*k; i++)
+                o[0].push_back(i);
+            return o;
+        }
+        std::vector<int> p(k);
+        for (int i = 0; i < k; i++)
+            p[i] = i;
+        std::vector<std::vector<int> > perms;
+        do {
+            perms.push_back(p);
+        } while (std::next_permutation(p.begin(), p.end()));
+        // Bands first, then the lines within each band in turn
+        std::vector<std::vector<int> > bands = perms;
+        o.clear();
+        for (size_t b = 0; b < bands.size(); b++) {
+            std::vector<std::vector<int> > part(1);
+            for (int i = 0; i < k; i++) {
+                std::vector<std::vector<int> > next;
+                for (size_t j = 0; j < part.size(); j++)
+                    for (size_t l = 0; l < perms.size(); l++) {
+                        std::vector<int> q = part[j];
+                        for (int m = 0; m < k; m++)
+                            q.push_back(bands[b][i]*k + perms[l][m]);
+                        next.push_back(q);
+                    }
+                part.swap(next);
+            }
+            o.insert(o.end(), part.begin(), part.end());
+        }
+        return o;
+    }
+
+    // Cell of the original grid at row r and column c of the form
+    int cell(bool t, int r, int c) const {
+        return t ? c*size + r : r*size + c;
+    }
+public:
+    // Canonical form of the puzzle
+    std::vector<int> form;
+
+    // Compute the canonical form of cells of a puzzle of order k0
+    Canonical(int k0, const std::vector<int>& cells)
+    : k(k0), size(k0*k0), transpose(false), label(k0*k0+1, 0) {
+        std::vector<std::vector<int> > o = orders(k);
+        // Row orders by their first row
+        std::vector<std::vector<int> > first(size);
+        for (size_t r = 0; r < o.size(); r++)
+            first[o[r][0]].push_back(r);
+        std::vector<int> lab(size+1), top(size+1), cand(size*size);
+        for (int t = 0; t < 2; t++)
+            for (int f = 0; f < size; f++)
+                for (size_t c = 0; c < o.size(); c++) {
+                    // The first row is shared by all row orders starting
+                    // with f, most column orders are dropped here
+                    std::fill(top.begin(), top.end(), 0);
+                    int next = 1;
+                    bool less = form.empty();
+                    int i = 0;
+                    for (; i < size; i++) {
+                        int v = cells[cell(t, f, o[c][i])];
+                        if ((v != 0) && (top[v] == 0))
+                            top[v] = next++;
+                        cand[i] = top[v];
+                        if (!less) {
+                            if (cand[i] > form[i])
+                                break;
+                            less = cand[i] < form[i];
+                        }
+                    }
+                    if (i < size)
+                        continue;
+                    int topNext = next;
+                    bool topLess = less;
+                    for (size_t j = 0; j < first[f].size(); j++) {
+                        const std::vector<int>& r = o[first[f][j]];
+                        lab = top;
+                        next = topNext;
+                        less = topLess;
+                        for (i = size; i < size*size; i++) {
+                            int v = cells[cell(t, r[i/size], o[c][i%size])];
+                            if ((v != 0) && (lab[v] == 0))
+                                lab[v] = next++;
+                            cand[i] = lab[v];
+                            if (!less) {
+                                if (cand[i] > form[i])
+                                    break;
+                                less = cand[i] < form[i];
+                            }
+                        }
+                        if ((i < size*size) || !less)
+                            continue;
+                        form = cand;
+                        transpose = (t == 1);
+                        rows = r; cols = o[c]; label = lab;
+                        topLess = false;
+                    }
+                }
+        // Digits without clues take the remaining labels
+        std::vector<bool> used(size+1, false);
+        for (int v = 1; v <= size; v++)
+            used[label[v]] = true;
+        int free = 1;
+        for (int v = 1; v <= size; v++)
+            if (label[v] == 0) {
+                while (used[free])
+                    free++;
+                label[v] = free++;
+            }
+    }
+
+    // Grid g of the original puzzle in canonical form
+    std::vector<int> canonize(const std::vector<int>& g) const {
+        std::vector<int> f(size*size);
+        for (int r = 0; r < size; r++)
+            for (int c = 0; c < size; c++)
+                f[r*size+c] = label[g[cell(transpose, rows[r], cols[c])]];
+        return f;
+    }
+
+    // Grid f in canonical form in terms of the original puzzle
+    std::vector<int> restore(const std::vector<int>& f) const {
+        std::vector<int> digit(size+1, 0), g(size*size);
+        for (int v = 1; v <= size; v++)
+            digit[label[v]] = v;
+        for (int r = 0; r < size; r++)
+            for (int c = 0; c < size; c++)
+                g[cell(transpose, rows[r], cols[c])] = digit[f[r*size+c]];
+        return g;
+    }
+};
+
+/*
+ * Solutions by canonical form, kept in memory and appended to a file.
+ * Every line holds the order, the canonical puzzle and its solution in
+ * canonical form (all 0 for a puzzle without solution).
+ */
+class SudokuCache {
+protected:
+    // File the cache lives in
+    std::string file;
+    // Solutions by order and canonical puzzle
+    std::map<std::pair<int,std::vector<int> >,std::vector<int> > solutions;
+public:
+    // Load the cache from file f (a missing file is an empty cache)
+    SudokuCache(const char* f) : file(f) {
+        std::ifstream in(f);
+        int k;
+        while (in >> k) {
+            std::vector<int> p(k*k*k*k), s(k*k*k*k);
+            for (size_t i = 0; i < p.size(); i++)
+                in >> p[i];
+            for (size_t i = 0; i < s.size(); i++)
+                in >> s[i];
+            if (!in)
+                break;
+            solutions[std::make_pair(k, p)] = s;
+        }
+    }
+
+    // Return the cached solution of form (NULL if there is none)
+    const std::vector<int>* find(int k, const std::vector<int>& form) const {
+        std::map<std::pair<int,std::vector<int> >,std::vector<int> >
+            ::const_iterator i = solutions.find(std::make_pair(k, form));
+        return (i == solutions.end()) ? NULL : &i->second;
+    }
+
+    // Store solution s of form and append it to the file
+    void store(int k, const std::vector<int>& form,
+               const std::vector<int>& s) {
+        if (find(k, form) != NULL)
+            return;
+        solutions[std::make_pair(k, form)] = s;
+        std::ofstream out(file.c_str(), std::ios::app);
+        out << k;
+        for (size_t i = 0; i < form.size(); i++)
+            out << ' ' << form[i];
+        for (size_t i = 0; i < s.size(); i++)
+            out << ' ' << s[i];
+        out << '\n';
+    }
+};
+
+#endif
@@ -0,0 +1,155 @@
+//
+// Dancing links (Algorithm X) for Sudoku
+//
+
+/*
+ * Sudoku as exact cover: a row for every cell and candidate value, and a
+ * column for every cell, every value in a row, every value in a column
+ * and every value in a block. A solution picks one row per cell such
+ * that every column is covered exactly once.
+ *
+ * The doubly linked lists live in flat arrays indexed by node number
+ * (node 0 is the root, nodes 1 to the number of columns are the column
+ * headers), so covering a column walks contiguous ints instead of
+ * chasing pointers to separately allocated nodes.
+ */
+
+#ifndef ASSIGNMENT1_DLX
+#define ASSIGNMENT1_DLX
+
+#include <vector>
+#include <stdint.h>
+
+class Dlx {
+protected:
+    // Order of the puzzle
+    int k;
+    // Number of values (and cells per unit)
+    int size;
+    // Links to the left, right, up and down node
+    std::vector<int> L, R, U, D;
+    // Column header of every node
+    std::vector<int> C;
+    // Sudoku row (cell*size + value-1) of every node
+    std::vector<int> row;
+    // Number of nodes in every column
+    std::vector<int> S;
+    // Rows of the current partial solution
+    std::vector<int> chosen;
+    // Number of search nodes
+    unsigned long int nodes;
+
+    // Add a node for column c to the row starting at first
+    int node(int c, int r, int first) {
+        int x = L.size();
+        L.push_back(x); R.push_back(x);
+        U.push_back(U[c]); D.push_back(c);
+        D[U[c]] = x; U[c] = x;
+        C.push_back(c); row.push_back(r);
+        S[c]++;
+        if (first >= 0) {
+            L[x] = L[first]; R[x] = first;
+            R[L[first]] = x; L[first] = x;
+        }
+        return x;
+    }
+
+    void cover(int c) {
+        R[L[c]] = R[c]; L[R[c]] = L[c];
+        for (int i = D[c]; i != c; i = D[i])
+            for (int j = R[i]; j != i; j = R[j]) {
+                D[U[j]] = D[j]; U[D[j]] = U[j];
+                S[C[j]]--;
+            }
+    }
+
+    void uncover(int c) {
+        for (int i = U[c]; i != c; i = U[i])
+            for (int j = L[i]; j != i; j = L[j]) {
+                S[C[j]]++;
+                D[U[j]] = j; U[D[j]] = j;
+            }
+        R[L[c]] = c; L[R[c]] = c;
+    }
+
+    // Search below the current partial solution
+    void search(unsigned long int limit,
+                std::vector<std::vector<int> >& found) {
+        nodes++;
+        if (R[0] == 0) {
+            std::vector<int> cells(size*size);
+            for (size_t i = 0; i < chosen.size(); i++)
+                cells[chosen[i] / size] = chosen[i] % size + 1;
+            found.push_back(cells);
+            return;
+        }
+        // Column with fewest rows
+        int c = R[0];
+        for (int j = R[c]; j != 0; j = R[j])
+            if (S[j] < S[c])
+                c = j;
+        if (S[c] == 0)
+            return;
+        cover(c);
+        for (int r = D[c]; r != c; r = D[r]) {
+            chosen.push_back(row[r]);
+            for (int j = R[r]; j != r; j = R[j])
+                cover(C[j]);
+            search(limit, found);
+            for (int j = L[r]; j != r; j = L[j])
+                uncover(C[j]);
+            chosen.pop_back();
+            if ((limit > 0) && (found.size() >= limit))
+                break;
+        }
+        uncover(c);
+    }
+public:
+    /*
+     * Initialize for a puzzle of order k0 with the given clues (0 for
+     * blank). If masks is not empty, only its candidates get a row.
+     */
+    Dlx(int k0, const std::vector<int>& cells,
+        const std::vector<uint64_t>& masks)
+    : k(k0), size(k0*k0), nodes(0) {
+        int columns = 4*size*size;
+        L.resize(columns+1); R.resize(columns+1);
+        U.resize(columns+1); D.resize(columns+1);
+        C.resize(columns+1); row.assign(columns+1, -1);
+        S.assign(columns+1, 0);
+        for (int c = 0; c <= columns; c++) {
+            L[c] = (c == 0) ? columns : c-1;
+            R[c] = (c == columns) ? 0 : c+1;
+            U[c] = D[c] = C[c] = c;
+        }
+        for (int i = 0; i < size*size; i++) {
+            int r = i / size, c = i % size, b = (r/k)*k + c/k;
+            for (int v = 0; v < size; v++) {
+                if ((cells[i] != 0) && (cells[i] != v+1))
+                    continue;
+                if (!masks.empty() && !(masks[i] & (1ULL << v)))
+                    continue;
+                int x = i*size + v;
+                int first = node(1 + i, x, -1);
+                node(1 + size*size + r*size + v, x, first);
+                node(1 + 2*size*size + c*size + v, x, first);
+                node(1 + 3*size*size + b*size + v, x, first);
+            }
+        }
+    }
+
+    // Find up to limit solutions (all if limit is 0)
+    std::vector<std::vector<int> > solve(unsigned long int limit) {
+        std::vector<std::vector<int> > found;
+        chosen.clear();
+        search(limit, found);
+        return found;
+    }
+
+    // Number of search nodes so far
+    unsigned long int statistics(void) const {
+        return nodes;
+    }
+};
+
+#endif
@@ -0,0 +1,174 @@
+//
+// Presolve for Sudoku on candidate bitmasks
+//
+
+/*
+ * Every cell holds the set of values it can still take as a bitmask
+ * (bit v-1 for value v), which covers grids up to order 8. Three rules
+ * run to a fixpoint over the rows, columns and blocks (units):
+ *  - naked singles: the value of a solved cell is removed from the other
+ *    cells of its units;
+ *  - hidden singles: a value that fits only one cell of a unit is placed
+ *    there;
+ *  - locked candidates: when the values of a block that fit into one of
+ *    its rows (or columns) fit nowhere else in the block, they are
+ *    removed from the rest of that row, and the other way round.
+ * The rules are sound, so a puzzle they solve has exactly that solution.
+ */
+
+#ifndef ASSIGNMENT1_PRESOLVE
+#define ASSIGNMENT1_PRESOLVE
+
+#include <vector>
+#include <stdint.h>
+
+class Presolve {
+public:
+    // Outcome of the presolve
+    enum Status {
+        FAILED,     // some cell or value has no place left
+        SOLVED,     // every cell has a single candidate
+        REDUCED     // search is still needed
+    };
+protected:
+    // Order of the puzzle
+    int k;
+    // Number of values (and cells per unit)
+    int size;
+    // All values
+    uint64_t full;
+    // Candidates of every cell
+    std::vector<uint64_t> cand;
+    // Cells of every unit: rows, then columns, then blocks
+    std::vector<std::vector<int> > units;
+
+    static bool single(uint64_t m) {
+        return (m & (m-1)) == 0;
+    }
+
+    // Naked and hidden singles in unit u
+    bool singles(const std::vector<int>& u, bool& changed) {
+        uint64_t solved = 0, once = 0, twice = 0;
+        for (size_t i = 0; i < u.size(); i++) {
+            uint64_t m = cand[u[i]];
+            if (m == 0)
+                return false;
+            if (single(m)) {
+                if (solved & m)
+                    return false;
+                solved |= m;
+            }
+            twice |= once & m;
+            once |= m;
+        }
+        if (once != full)
+            return false;
+        uint64_t hidden = once & ~twice & ~solved;
+        for (size_t i = 0; i < u.size(); i++) {
+            uint64_t& m = cand[u[i]];
+            if (single(m))
+                continue;
+            uint64_t r = m & ~solved;
+            if (r & hidden) {
+                // Two values that fit only here cannot both be placed
+                if (!single(r & hidden))
+                    return false;
+                r &= hidden;
+            }
+            if (r == 0)
+                return false;
+            if (r != m) {
+                m = r;
+                changed = true;
+            }
+        }
+        return true;
+    }
+
+    // Locked candidates between block b and the line l crossing it
+    void locked(const std::vector<int>& b, const std::vector<int>& l,
+                bool& changed) {
+        // Values in the intersection, the rest of the block and the line
+        uint64_t in = 0, block = 0, line = 0;
+        std::vector<bool> shared(size*size, false);
+        for (size_t i = 0; i < b.size(); i++)
+            for (size_t j = 0; j < l.size(); j++)
+                if (b[i] == l[j])
+                    shared[b[i]] = true;
+        for (size_t i = 0; i < b.size(); i++)
+            (shared[b[i]] ? in : block) |= cand[b[i]];
+        for (size_t j = 0; j < l.size(); j++)
+            if (!shared[l[j]])
+                line |= cand[l[j]];
+        // Pointing: only the line can take these values of the block
+        uint64_t pointing = in & ~block;
+        // Claiming: only the block can take these values of the line
+        uint64_t claiming = in & ~line;
+        for (size_t j = 0; j < l.size(); j++)
+            if (!shared[l[j]] && (cand[l[j]] & pointing)) {
+                cand[l[j]] &= ~pointing;
+                changed = true;
+            }
+        for (size_t i = 0; i < b.size(); i++)
+            if (!shared[b[i]] && (cand[b[i]] & claiming)) {
+                cand[b[i]] &= ~claiming;
+                changed = true;
+            }
+    }
+public:
+    // Initialize from the clues of a puzzle of order k0 <= 8 (0 for blank)
+    Presolve(int k0, const std::vector<int>& cells)
+    : k(k0), size(k0*k0), cand(cells.size()), units(3*k0*k0) {
+        full = (size == 64) ? ~0ULL : (1ULL << size) - 1;
+        for (size_t i = 0; i < cells.size(); i++)
+            cand[i] = (cells[i] == 0) ? full : 1ULL << (cells[i]-1);
+        for (int r = 0; r < size; r++)
+            for (int c = 0; c < size; c++) {
+                units[r].push_back(r*size+c);
+                units[size+c].push_back(r*size+c);
+                units[2*size + (r/k)*k + c/k].push_back(r*size+c);
+            }
+    }
+
+    // Run the rules to a fixpoint
+    Status run(void) {
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (size_t u = 0; u < units.size(); u++)
+                if (!singles(units[u], changed))
+                    return FAILED;
+            if (changed)
+                continue;
+            for (int b = 0; b < size; b++) {
+                const std::vector<int>& block = units[2*size+b];
+                for (int i = 0; i < k; i++) {
+                    locked(block, units[(b/k)*k+i], changed);
+                    locked(block, units[size+(b%k)*k+i], changed);
+                }
+            }
+        }
+        for (size_t i = 0; i < cand.size(); i++)
+            if (!single(cand[i]))
+                return REDUCED;
+        return SOLVED;
+    }
+
+    // Candidates of all cells
+    const std::vector<uint64_t>& candidates(void) const {
+        return cand;
+    }
+
+    // Values of all cells, 0 where there is more than one candidate
+    std::vector<int> values(void) const {
+        std::vector<int> v(cand.size(), 0);
+        for (size_t i = 0; i < cand.size(); i++)
+            if (single(cand[i]))
+                for (int j = 0; j < size; j++)
+                    if (cand[i] == (1ULL << j))
+                        v[i] = j+1;
+        return v;
+    }
+};
+
+#endif
@@ -1,6 +1,7 @@
 #include <gecode/driver.hh>
 #include <gecode/int.hh>
 #include <gecode/minimodel.hh>
+#include "../common/sink.cpp"
 
 using namespace Gecode;
 
@@ -64,15 +65,20 @@ public:
     /// Print solution
     virtual void
     print(std::ostream& os) const {
+        Sink::Timer timer;
+        if (Sink::compact()) {
+            Sink::line(os, q, 0);
+            return;
+        }
         int size = sqrt(q.size());
 
         os << "\t";
         for (int i = 0; i < q.size(); i++) {
             os << q[i] << ", ";
             if ((i+1) % size == 0)
-                os << std::endl << "\t";
+                os << "\n\t";
         }
-        os << std::endl;
+        os << '\n';
     }
 };
 
@@ -87,7 +93,10 @@ int main(int argc, char* argv[]) {
     //    opt.inspect.click(&ki);
     //#endif
     
+    SinkOption sink;
+    opt.add(sink);
     opt.parse(argc,argv);
+    Sink::install(std::cout, sink.value());
     Script::run<Queens,DFS,SizeOptions>(opt);
     return 0;
 }
@@ -1,110 +1,574 @@
 
 #include <iostream>
+#include <fstream>
 #include <string>
+#include <vector>
+#include <cctype>
+#include <algorithm>
+#include <chrono>
 #include <gecode/int.hh>
 #include <gecode/search.hh>
 #include <gecode/gist.hh>
 #include <gecode/driver.hh>
 #include <gecode/minimodel.hh>
 #include "A1.cpp"
+#include "presolve.cpp"
+#include "dlx.cpp"
+#include "canonical.cpp"
+#include "../common/sink.cpp"
 
 
 using namespace Gecode;
 extern int examples[][9][9];
 
+// Order of the puzzle: the grid is order^2 x order^2
+int order = 3;
+// Cells of the puzzle row by row, 0 for blank
+std::vector<int> puzzle;
+// Candidates of every cell left by the presolve, empty without presolve
+std::vector<uint64_t> candidates;
+
+// What to do with the puzzle
+enum {
+    TASK_SOLVE,     // search for solutions
+    TASK_UNIQUE,    // check whether there is exactly one solution
+    TASK_MINIMIZE   // remove clues while the solution stays unique
+};
+
+// How to search for solutions
+enum {
+    BACKEND_CP,     // Gecode space
+    BACKEND_DLX,    // dancing links
+    BACKEND_CHECK   // both, comparing the solutions found
+};
+
+class SudokuOptions : public Options {
+protected:
+    // File with a puzzle of any order
+    Driver::StringValueOption _file;
+    // What to do with the puzzle
+    Driver::StringOption _task;
+    // Whether to presolve the puzzle on bitmasks
+    Driver::BoolOption _presolve;
+    // How to search for solutions
+    Driver::StringOption _backend;
+    // Whether to strengthen distinct on restarts
+    Driver::BoolOption _adaptive;
+    // Failures after which to restart and strengthen
+    Driver::UnsignedIntOption _adaptiveFails;
+    // File of cached solutions by canonical form
+    Driver::StringValueOption _cache;
+    // How to write solutions
+    SinkOption _sink;
+public:
+    SudokuOptions(const char* s)
+    : Options(s),
+      _file("-file", "read puzzle from file instead of the examples"),
+      _task("-task", "what to do with the puzzle", TASK_SOLVE),
+      _presolve("-presolve", "presolve the puzzle on bitmasks", true),
+      _backend("-backend", "how to search for solutions", BACKEND_CP),
+      _adaptive("-adaptive",
+                "start with value consistency, strengthen on restarts", false),
+      _adaptiveFails("-adaptive-fails",
+                     "failures after which to restart and strengthen", 50),
+      _cache("-cache", "file of cached solutions by canonical form") {
+        _task.add(TASK_SOLVE, "solve", "search for solutions");
+        _task.add(TASK_UNIQUE, "unique", "stop at the second solution");
+        _task.add(TASK_MINIMIZE, "minimize",
+                  "remove clues while the solution stays unique");
+        _backend.add(BACKEND_CP, "cp", "search with Gecode");
+        _backend.add(BACKEND_DLX, "dlx", "search with dancing links");
+        _backend.add(BACKEND_CHECK, "check",
+                     "search with both and compare the solutions");
+        add(_file);
+        add(_task);
+        add(_presolve);
+        add(_backend);
+        add(_adaptive);
+        add(_adaptiveFails);
+        add(_cache);
+        add(_sink);
+    }
+    const char* file(void) const {
+        return _file.value();
+    }
+    int task(void) const {
+        return _task.value();
+    }
+    bool presolve(void) const {
+        return _presolve.value();
+    }
+    int backend(void) const {
+        return _backend.value();
+    }
+    bool adaptive(void) const {
+        return _adaptive.value();
+    }
+    unsigned int adaptiveFails(void) const {
+        return _adaptiveFails.value();
+    }
+    const char* cache(void) const {
+        return _cache.value();
+    }
+    int sink(void) const {
+        return _sink.value();
+    }
+};
+
+/*
+ * Read a puzzle from file f. The file starts with the order k followed
+ * by the k^4 cells row by row, separated by white space. A cell is 0 or
+ * '.' when blank, otherwise its value as a number or as a letter (A for
+ * 10, B for 11, ...). Orders above 8 are rejected: the candidates of a
+ * cell are kept as a 64-bit mask, which holds at most 8^2 values.
+ */
+bool readPuzzle(const char* f) {
+    std::ifstream in(f);
+    if (!(in >> order) || (order < 1) || (order > 8))
+        return false;
+    int size = order*order;
+    puzzle.assign(size*size, 0);
+    for (int i = 0; i < size*size; i++) {
+        std::string c;
+        if (!(in >> c))
+            return false;
+        if (c == ".")
+            puzzle[i] = 0;
+        else if (isalpha(c[0]))
+            puzzle[i] = 10 + toupper(c[0]) - 'A';
+        else
+            puzzle[i] = atoi(c.c_str());
+        if ((puzzle[i] < 0) || (puzzle[i] > size))
+            return false;
+    }
+    return true;
+}
+
+// Print the cells of a grid of order k, digits above 9 as letters
+void printGrid(std::ostream& os, int k, const std::vector<int>& cells) {
+    Sink::Timer timer;
+    int size = k*k;
+    if (Sink::compact()) {
+        for (int i = 0; i < size*size; i++) {
+            if ((i > 0) && (size > 9))
+                os << ' ';
+            os << cells[i];
+        }
+        os << '\n';
+        return;
+    }
+    os << '\t';
+    for (int i = 0; i < size*size; i++) {
+        int v = cells[i];
+        if (v < 10)
+            os << v << " ";
+        else if (v < 36)
+            os << (char)(v+'A'-10) << " ";
+        else
+            os << v << " ";
+        if((i+1)%(size) == 0)
+            os << "\n\t";
+    }
+}
+
 class SudokuSolver : public Script{
     protected :
+        // Order of the puzzle
+        int k;
         IntVarArray n;
-    public:
-    SudokuSolver(const Options& opt) : Script(opt), n(*this, 81, 1, 9){
+        // Whether distinct is strengthened on restarts
+        bool adaptive;
+        // Failures between restarts that trigger strengthening
+        unsigned int threshold;
+        // Units (rows, columns, blocks) with domain consistent distinct
+        std::vector<bool> strong;
 
-        //Prompt user to select a puzzle
-        int in;
-        std::cout << "Please enter puzzle number (0-17): ";
-        std::cin >> in;
+        // Cells of unit u: rows, then columns, then blocks
+        IntVarArgs unit(int u) const {
+            int size = k*k;
+            Matrix<IntVarArgs> mat(n,size,size);
+            if (u < size)
+                return mat.row(u);
+            if (u < 2*size)
+                return mat.col(u-size);
+            int b = u - 2*size;
+            return mat.slice((b%k)*k, (b%k)*k+k, (b/k)*k, (b/k)*k+k);
+        }
+    public:
+    SudokuSolver(const SudokuOptions& opt, bool clues = true)
+    : Script(opt), k(order), n(*this, order*order*order*order, 1, order*order),
+      adaptive(opt.adaptive()), threshold(opt.adaptiveFails()),
+      strong(3*order*order, false){
 
+        int size = k*k;
 
-        
-        //Get example from A1.cpp
-        static int example [9][9];
-        for (int i=0; i<9; i++){
-            for (int j = 0; j<9 ; j++){
-                example[i][j] = examples[in][i][j];
-            }
-        }
-        
         //Constraints
 
         //Example to solve
-        static int findSolution [81];
-        for (int i=0; i<9; i++){
-            for (int j = 0; j<9 ; j++){
-                findSolution[(i*9)+j] = example[i][j];
-                if( example[i][j] != 0){
-                    rel(*this, n[(i*9)+j], IRT_EQ, example[i][j]);
-                }
-            }
+        if (clues) {
+            given(puzzle);
+            reduce(candidates);
         }
 
-        Matrix<IntVarArgs> mat(n,9,9);
+        Matrix<IntVarArgs> mat(n,size,size);
+
+        // Adaptive propagation starts cheap
+        IntConLevel icl = adaptive ? ICL_VAL : opt.icl();
 
         // Rows and columns constraints
-        for (int i=0; i<9; i++){
-            distinct(*this, mat.row(i), opt.icl());
-            distinct(*this, mat.col(i), opt.icl());
+        for (int i=0; i<size; i++){
+            distinct(*this, mat.row(i), icl);
+            distinct(*this, mat.col(i), icl);
         }
 
 
-        // 3x3 blocks constraint
-        for (int i=0; i<9; i+=3){
-            for (int j=0; j<9; j+=3){
-                distinct(*this, mat.slice(i, i+3, j, j+3), opt.icl());
+        // kxk blocks constraint
+        for (int i=0; i<size; i+=k){
+            for (int j=0; j<size; j+=k){
+                distinct(*this, mat.slice(i, i+k, j, j+k), icl);
             }
         }
 
         //Branching
         branch(*this, n, INT_VAR_SIZE_MIN(), INT_VAL_MIN());
-        
-        
+
+
     }
-    
-    
+
+
+    // Post the clues of cells (0 for blank)
+    void given(const std::vector<int>& cells) {
+        for (int i=0; i<n.size(); i++){
+            if( cells[i] != 0){
+                rel(*this, n[i], IRT_EQ, cells[i]);
+            }
+        }
+    }
+
+    // Restrict the cells to the candidates left by the presolve
+    void reduce(const std::vector<uint64_t>& masks) {
+        if (masks.empty())
+            return;
+        int size = k*k;
+        std::vector<int> values(size);
+        for (int i=0; i<n.size(); i++){
+            int m = 0;
+            for (int v=1; v<=size; v++)
+                if (masks[i] & (1ULL << (v-1)))
+                    values[m++] = v;
+            if (m < size)
+                dom(*this, n[i], IntSet(&values[0], m));
+        }
+    }
+
+    /*
+     * On a restart after at least threshold failures, post domain
+     * consistent distinct on the half of the remaining units whose cells
+     * have the highest accumulated failure count.
+     */
+    virtual bool master(const MetaInfo& mi) {
+        if (adaptive && (mi.fail() >= threshold)) {
+            std::vector<std::pair<double,int> > weak;
+            for (int u = 0; u < (int) strong.size(); u++) {
+                if (strong[u])
+                    continue;
+                IntVarArgs x = unit(u);
+                double afc = 0.0;
+                for (int i = 0; i < x.size(); i++)
+                    afc += x[i].afc(*this);
+                weak.push_back(std::make_pair(-afc, u));
+            }
+            std::sort(weak.begin(), weak.end());
+            for (size_t i = 0; i < (weak.size()+1)/2; i++) {
+                strong[weak[i].second] = true;
+                distinct(*this, unit(weak[i].second), ICL_DOM);
+            }
+        }
+        return Script::master(mi);
+    }
+
     // Constructor for cloning
-    SudokuSolver(bool share, SudokuSolver& s) : Script(share, s) {
+    SudokuSolver(bool share, SudokuSolver& s)
+    : Script(share, s), k(s.k), adaptive(s.adaptive),
+      threshold(s.threshold), strong(s.strong) {
         n.update(*this, share, s.n);
     }
     // Perform copying during cloning
     virtual Space* copy(bool share) {
         return new SudokuSolver(share,*this);
     }
-    
+
+    // Values of the cells, 0 where not assigned
+    std::vector<int> values(void) const {
+        std::vector<int> cells(n.size());
+        for (int i = 0; i<n.size(); i++)
+            cells[i] = n[i].assigned() ? n[i].val() : 0;
+        return cells;
+    }
+
     /// Print solution
     virtual void
     print(std::ostream& os) const {
-        os << '\t';
-        for (int i = 0; i<81; i++) {
-            for (int j=0; j<9; j++) {
-                    if (j+1<10)
-                        os << n[i] << " ";
-                    else
-                        os << (char)(j+1+'A'-10) << " ";
-                    break;
-            }
-            if((i+1)%(9) == 0)
-                os << std::endl << '\t';
-        }
+        printGrid(os, k, values());
     }
-    
-    
+
+
 };
 
+/*
+ * Number of solutions of the clues cells, counting at most up to limit.
+ * The clues are posted on a clone of base, a space holding the model
+ * without clues whose propagation has already been done. Without base
+ * the solutions are counted with dancing links.
+ */
+int solutions(SudokuSolver* base, const std::vector<int>& cells, int limit) {
+    if (base == NULL) {
+        Dlx d(order, cells, std::vector<uint64_t>());
+        return d.solve(limit).size();
+    }
+    SudokuSolver* s = static_cast<SudokuSolver*>(base->clone());
+    s->given(cells);
+    Search::Options so;
+    so.clone = false;
+    DFS<SudokuSolver> e(s, so);
+    int found = 0;
+    while (found < limit) {
+        SudokuSolver* t = e.next();
+        if (t == NULL)
+            break;
+        delete t;
+        found++;
+    }
+    return found;
+}
+
+/*
+ * Remove clues from the puzzle one by one, keeping the removal whenever
+ * the solution stays unique. The result is minimal: no single clue can
+ * be removed any more.
+ */
+int minimize(SudokuSolver* base, std::vector<int>& cells) {
+    int checks = 0;
+    for (size_t i = 0; i < cells.size(); i++) {
+        if (cells[i] == 0)
+            continue;
+        int v = cells[i];
+        cells[i] = 0;
+        checks++;
+        if (solutions(base, cells, 2) != 1)
+            cells[i] = v;
+    }
+    return checks;
+}
+
+/*
+ * First solution of the puzzle (empty if there is none), using the
+ * presolve and the backend selected by opt.
+ */
+std::vector<int> firstSolution(const SudokuOptions& opt) {
+    if (opt.presolve()) {
+        Presolve p(order, puzzle);
+        switch (p.run()) {
+        case Presolve::FAILED:
+            return std::vector<int>();
+        case Presolve::SOLVED:
+            return p.values();
+        case Presolve::REDUCED:
+            candidates = p.candidates();
+            break;
+        }
+    }
+    if (opt.backend() == BACKEND_DLX) {
+        Dlx d(order, puzzle, candidates);
+        std::vector<std::vector<int> > found = d.solve(1);
+        return found.empty() ? std::vector<int>() : found[0];
+    }
+    DFS<SudokuSolver> e(new SudokuSolver(opt));
+    SudokuSolver* s = e.next();
+    if (s == NULL)
+        return std::vector<int>();
+    std::vector<int> v = s->values();
+    delete s;
+    return v;
+}
+
 int main( int argc, char* argv[]){
-    Options opt("Sudoku");
+    SudokuOptions opt("Sudoku");
     opt.solutions(0);
     opt.iterations(200000);
-    
+
     opt.parse(argc,argv);
-    Script::run<SudokuSolver,DFS,Options>(opt);
+
+    // Strengthening happens on restarts cut off after the failure threshold.
+    // The branching is deterministic, so constant cutoffs would repeat the
+    // same search forever once every unit is strong. Luby cutoffs are
+    // multiples of the threshold that keep growing, so the search still
+    // completes. Restarts find the same solution again, so stop at the
+    // first one.
+    if (opt.adaptive()) {
+        if (opt.restart() == RM_NONE) {
+            opt.restart(RM_LUBY);
+            opt.restart_scale(opt.adaptiveFails());
+        }
+        if (opt.solutions() == 0)
+            opt.solutions(1);
+    }
+
+    if (opt.file() != NULL) {
+        if (!readPuzzle(opt.file())) {
+            std::cerr << "Could not read puzzle (of order 1 to 8) from "
+                      << opt.file() << std::endl;
+            return 1;
+        }
+    } else {
+        //Prompt user to select a puzzle
+        int in;
+        std::cout << "Please enter puzzle number (0-17): ";
+        std::cin >> in;
+
+        //Get example from A1.cpp
+        order = 3;
+        puzzle.assign(81, 0);
+        for (int i=0; i<9; i++){
+            for (int j = 0; j<9 ; j++){
+                puzzle[(i*9)+j] = examples[in][i][j];
+            }
+        }
+    }
+
+    // All input is read, solutions can be buffered from here
+    Sink::install(std::cout, opt.sink());
+
+    // Equivalent puzzles are answered from the cache without any search
+    if ((opt.cache() != NULL) && (opt.task() == TASK_SOLVE)) {
+        SudokuCache cache(opt.cache());
+        Canonical c(order, puzzle);
+        const std::vector<int>* f = cache.find(order, c.form);
+        std::vector<int> solution;
+        if (f != NULL) {
+            if ((*f)[0] != 0)
+                solution = c.restore(*f);
+        } else {
+            solution = firstSolution(opt);
+            cache.store(order, c.form, solution.empty() ?
+                        std::vector<int>(puzzle.size(), 0) :
+                        c.canonize(solution));
+        }
+        const char* from = (f != NULL) ? " (cached)" : "";
+        if (solution.empty()) {
+            std::cout << "No solution" << from << '\n';
+        } else {
+            std::cout << "Solution" << from << ":" << '\n';
+            printGrid(std::cout, order, solution);
+            std::cout << '\n';
+        }
+        return 0;
+    }
+
+    // Deduce what the bitmasks can before creating any space
+    if (opt.presolve() && (opt.task() != TASK_MINIMIZE)) {
+        Presolve p(order, puzzle);
+        switch (p.run()) {
+        case Presolve::FAILED:
+            std::cout << "No solution (found by presolve)" << '\n';
+            return 0;
+        case Presolve::SOLVED:
+            if (opt.task() == TASK_UNIQUE) {
+                std::cout << "Unique solution (found by presolve)" << '\n';
+            } else {
+                std::cout << "Solved by presolve:" << '\n';
+                printGrid(std::cout, order, p.values());
+                std::cout << '\n';
+            }
+            return 0;
+        case Presolve::REDUCED:
+            if (opt.task() == TASK_SOLVE)
+                candidates = p.candidates();
+            break;
+        }
+    }
+
+    if ((opt.task() == TASK_SOLVE) && (opt.backend() == BACKEND_CP)) {
+        Script::run<SudokuSolver,DFS,SudokuOptions>(opt);
+        return 0;
+    }
+
+    if (opt.task() == TASK_SOLVE) {
+        std::chrono::steady_clock::time_point t =
+            std::chrono::steady_clock::now();
+        Dlx d(order, puzzle, candidates);
+        std::vector<std::vector<int> > found = d.solve(opt.solutions());
+        double ms = std::chrono::duration_cast<std::chrono::microseconds>
+            (std::chrono::steady_clock::now() - t).count() / 1000.0;
+        if (opt.backend() == BACKEND_DLX) {
+            for (size_t i = 0; i < found.size(); i++) {
+                printGrid(std::cout, order, found[i]);
+                std::cout << '\n' << "----------" << '\n';
+            }
+            std::cout << '\n' << "Summary (dancing links)" << '\n'
+                      << "\truntime:      " << ms << " ms" << '\n'
+                      << "\tsolutions:    " << found.size() << '\n'
+                      << "\tnodes:        " << d.statistics() << '\n';
+            return 0;
+        }
+        // Collect the same number of solutions with Gecode and compare
+        std::vector<std::vector<int> > other;
+        DFS<SudokuSolver> e(new SudokuSolver(opt));
+        while ((opt.solutions() == 0) || (other.size() < opt.solutions())) {
+            SudokuSolver* s = e.next();
+            if (s == NULL)
+                break;
+            other.push_back(s->values());
+            delete s;
+        }
+        // With the limit reached the backends may stop at different ones
+        bool complete = (opt.solutions() == 0) ||
+            (found.size() < opt.solutions()) || (other.size() < opt.solutions());
+        std::sort(found.begin(), found.end());
+        std::sort(other.begin(), other.end());
+        if (complete ? (found != other) : (found.size() != other.size())) {
+            std::cout << "Mismatch: dancing links finds " << found.size()
+                      << " solutions, Gecode finds " << other.size()
+                      << '\n';
+            return 1;
+        }
+        std::cout << "Both backends find the same " << found.size()
+                  << " solutions" << '\n';
+        return 0;
+    }
+
+    // Propagate the model without clues once, every check clones it
+    SudokuSolver* base = NULL;
+    if (opt.backend() != BACKEND_DLX) {
+        base = new SudokuSolver(opt, false);
+        (void) base->status();
+    }
+
+    int found = solutions(base, puzzle, 2);
+    if (opt.task() == TASK_UNIQUE) {
+        if (found == 0)
+            std::cout << "No solution" << '\n';
+        else if (found == 1)
+            std::cout << "Unique solution" << '\n';
+        else
+            std::cout << "Several solutions" << '\n';
+    } else if (found != 1) {
+        std::cout << "Only puzzles with a unique solution can be minimized"
+                  << '\n';
+    } else {
+        int clues = 0;
+        for (size_t i = 0; i < puzzle.size(); i++)
+            clues += (puzzle[i] != 0);
+        int checks = minimize(base, puzzle);
+        int left = 0;
+        for (size_t i = 0; i < puzzle.size(); i++)
+            left += (puzzle[i] != 0);
+        std::cout << "Minimal puzzle (" << left << " of " << clues
+                  << " clues, " << checks << " checks):" << '\n';
+        printGrid(std::cout, order, puzzle);
+        std::cout << '\n';
+    }
+    delete base;
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,231 @@
+/*
+ * Bottom-left placement branching for square packing.
+ *
+ * Branching on all x before any y fixes columns of squares that cannot
+ * be checked against each other until their rows are known. This
+ * brancher builds the packing from its bottom-left corner instead: it
+ * takes the lowest, then leftmost cell that is not yet covered and either
+ * places a square with its corner on it or leaves it empty. A cell left
+ * empty stays empty: later squares are placed on cells after it in the
+ * same order, and a square on a later cell covers no earlier one. So
+ * the brancher only has to remember the first cell it may still use,
+ * and every alternative is a fully placed square.
+ *
+ * The alternatives are the squares, largest first, whose domains allow
+ * the cell as their corner and that fit into the free cells there, and
+ * leaving the cell empty as the last one. Each commit posts that every
+ * square still to be placed has its corner on or after the first cell
+ * that may still be used, as S*y + x >= S*fy + fx for a board of width
+ * S. Propagation can then not place a square on a cell left empty
+ * either.
+ */
+
+#ifndef ASSIGNMENT3_BOTTOM_LEFT
+#define ASSIGNMENT3_BOTTOM_LEFT
+
+#include <gecode/int.hh>
+#include <vector>
+#include <algorithm>
+#include "../common/profile.cpp"
+
+using namespace Gecode;
+using namespace Gecode::Int;
+
+class BottomLeftBrancher : public Brancher {
+protected:
+    // The x-coordinates
+    ViewArray<IntView> x;
+    // The y-coordinates
+    ViewArray<IntView> y;
+    // The sizes (array)
+    int* w;
+    // The size of the enclosing square
+    IntView s;
+    // First cell that may still be used, cells before it are done
+    int fx, fy;
+    // Description
+    class Description : public Choice {
+    public:
+        // The cell
+        int cx, cy;
+        // Squares that may go on the cell (empty is the last alternative)
+        int n;
+        int* cand;
+        Description(const Brancher& b, int x0, int y0, int n0, const int* c)
+        : Choice(b,n0+1), cx(x0), cy(y0), n(n0), cand(new int[n0+1]) {
+            for (int i = 0; i < n; i++)
+                cand[i] = c[i];
+        }
+        ~Description(void) {
+            delete [] cand;
+        }
+        // Report size occupied
+        virtual size_t size(void) const {
+            return sizeof(Description) + n*sizeof(int);
+        }
+        // Archive the choice's information in e
+        virtual void archive(Archive& e) const {
+            Choice::archive(e);
+            e << cx << cy << n;
+            for (int i = 0; i < n; i++)
+                e << cand[i];
+        }
+    };
+
+    // Whether square i is placed
+    bool placed(int i) const {
+        return x[i].assigned() && y[i].assigned();
+    }
+
+    // Cells of the S x S square covered by the placed squares
+    std::vector<char> covered(int S) const {
+        std::vector<char> g(S*S, 0);
+        for (int i = 0; i < x.size(); i++)
+            if (placed(i)) {
+                int r1 = std::min(y[i].val()+w[i], S);
+                int c1 = std::min(x[i].val()+w[i], S);
+                for (int r = y[i].val(); r < r1; r++)
+                    for (int c = x[i].val(); c < c1; c++)
+                        g[r*S+c] = 1;
+            }
+        return g;
+    }
+public:
+    // Construct branching
+    BottomLeftBrancher(Home home, ViewArray<IntView>& x0,
+                       ViewArray<IntView>& y0, int w0[], IntView s0)
+    : Brancher(home), x(x0), y(y0), w(w0), s(s0), fx(0), fy(0) {}
+    // Post branching
+    static void post(Home home, ViewArray<IntView>& x,
+                     ViewArray<IntView>& y, int w[], IntView s) {
+        (void) new (home) BottomLeftBrancher(home,x,y,w,s);
+    }
+
+    // Copy constructor used during cloning of b
+    BottomLeftBrancher(Space& home, bool share, BottomLeftBrancher& b)
+    : Brancher(home, share, b), fx(b.fx), fy(b.fy) {
+        x.update(home,share,b.x);
+        y.update(home,share,b.y);
+        s.update(home,share,b.s);
+        w = home.alloc<int>(x.size());
+        for (int i=x.size(); i--; )
+            w[i]=b.w[i];
+    }
+    // Copy brancher
+    virtual Actor* copy(Space& home, bool share) {
+        return new (home) BottomLeftBrancher(home, share, *this);
+    }
+
+    // Check status of brancher, return true if alternatives left
+    virtual bool status(const Space&) const {
+        for (int i = 0; i < x.size(); i++)
+            if (!placed(i))
+                return true;
+        return false;
+    }
+    // Return choice as description
+    virtual Choice* choice(Space&) {
+        PROFILE_SCOPE(prof, "BottomLeftBrancher::choice");
+        int S = s.max();
+        std::vector<char> g = covered(S);
+        // the first free cell from the frontier on
+        int cx = -1, cy = -1;
+        for (int r = fy; (r < S) && (cy < 0); r++)
+            for (int c = (r == fy) ? fx : 0; c < S; c++)
+                if (!g[r*S+c]) {
+                    cx = c; cy = r;
+                    break;
+                }
+        std::vector<int> cand;
+        if (cy >= 0)
+            for (int i = 0; i < x.size(); i++) {
+                if (placed(i) || !x[i].in(cx) || !y[i].in(cy) ||
+                    (cx+w[i] > S) || (cy+w[i] > S))
+                    continue;
+                bool fits = true;
+                for (int r = cy; fits && (r < cy+w[i]); r++)
+                    for (int c = cx; fits && (c < cx+w[i]); c++)
+                        fits = !g[r*S+c];
+                if (fits)
+                    cand.push_back(i);
+            }
+        // with no cell left the only alternative fails
+        return new Description(*this, cx, cy, cand.size(),
+                               cand.empty() ? NULL : &cand[0]);
+    }
+    // Construct choice from archive e
+    virtual const Choice* choice(const Space&, Archive& e) {
+        int cx, cy, n;
+        e >> cx >> cy >> n;
+        std::vector<int> cand(n);
+        for (int i = 0; i < n; i++)
+            e >> cand[i];
+        return new Description(*this, cx, cy, n,
+                               cand.empty() ? NULL : &cand[0]);
+    }
+    // Perform commit for choice c and alternative a
+    virtual ExecStatus commit(Space& home, const Choice& c, unsigned int a) {
+        const Description& d = static_cast<const Description&>(c);
+        if (d.cy < 0)
+            return ES_FAILED;
+        if (a < static_cast<unsigned int>(d.n)) {
+            // place the square on the cell
+            int i = d.cand[a];
+            fx = d.cx; fy = d.cy;
+            if (me_failed(x[i].eq(home, d.cx)) ||
+                me_failed(y[i].eq(home, d.cy)))
+                return ES_FAILED;
+        } else {
+            // leave the cell empty
+            fx = d.cx+1; fy = d.cy;
+        }
+        // the squares still to be placed start on or after the first
+        // cell that may still be used
+        int S = s.max();
+        for (int i = 0; i < x.size(); i++)
+            if (!placed(i)) {
+                if (me_failed(y[i].gq(home, fy)))
+                    return ES_FAILED;
+                // in the row of that cell, not left of it
+                if ((y[i].min() == fy) && (x[i].min() < fx)) {
+                    IntArgs a(2);
+                    a[0] = S; a[1] = 1;
+                    IntVarArgs v(2);
+                    v[0] = IntVar(y[i]); v[1] = IntVar(x[i]);
+                    linear(home, a, v, IRT_GQ, S*fy + fx);
+                }
+            }
+        return home.failed() ? ES_FAILED : ES_OK;
+    }
+    // Print some information on stream o
+    virtual void print(const Space&, const Choice& c, unsigned int a,
+                       std::ostream& o) const {
+        const Description& d = static_cast<const Description&>(c);
+        if (a < static_cast<unsigned int>(d.n))
+            o << "square " << d.cand[a] << " at " << d.cx << "," << d.cy;
+        else
+            o << "empty " << d.cx << "," << d.cy;
+    }
+};
+
+/*
+ * Branch on the squares at x, y with sizes w inside the enclosing square
+ * of size s, placing them from the bottom-left corner. s should be
+ * assigned before.
+ */
+void bottomleft(Home home, const IntVarArgs& x, const IntVarArgs& y,
+                const IntArgs& w, IntVar s) {
+    // Check whether arguments make sense
+    if ((x.size() != y.size()) || (x.size() != w.size()))
+        throw ArgumentSizeMismatch("bottomleft");
+    // Never post a branching in a failed space
+    if (home.failed()) return;
+    ViewArray<IntView> vx(home,x);
+    ViewArray<IntView> vy(home,y);
+    int* wc = static_cast<Space&>(home).alloc<int>(x.size());
+    for (int i=x.size(); i--; )
+        wc[i]=w[i];
+    BottomLeftBrancher::post(home,vx,vy,wc,IntView(s));
+}
+
+#endif
@@ -0,0 +1,108 @@
+/*
+ * On-disk cache of optimal packings.
+ *
+ * The file has one line per n: n, the optimal s and the position x y of
+ * every square from the largest (size n) to the smallest (size 1). A
+ * square the model did not place has position -1 -1.
+ *
+ * For an n that is not cached the other entries still bound s, because
+ * s is monotone in n: a packing for n contains one for every m < n.
+ */
+
+#ifndef ASSIGNMENT3_CACHE
+#define ASSIGNMENT3_CACHE
+
+#include <map>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+// An optimal packing of the squares of size n..1
+class Packing {
+public:
+    int n;
+    int s;
+    // Positions of the square of size n-i
+    std::vector<int> x, y;
+
+    Packing(void) : n(0), s(0) {}
+    Packing(int n0, int s0) : n(n0), s(s0), x(n0,-1), y(n0,-1) {}
+
+    // Print like Square::print, saying where the packing is from
+    void print(std::ostream& os, const char* from = "cached") const {
+        os << "\t";
+        os << "Smallest S = " << s << " (" << from << ")" << "\n\t";
+        os << "For N = " << n << "\n\t";
+        for (int i = 0; i < n; i++) {
+            if (x[i] >= 0) {
+                os << "square with size " << n-i << "\tPosition: "
+                   << x[i] << "," << y[i];
+                os << "\n\t";
+            }
+        }
+        os << '\n';
+    }
+};
+
+class PackingCache {
+protected:
+    // File the cache lives in
+    std::string file;
+    // Cached packings by n
+    std::map<int,Packing> packings;
+public:
+    // Load the cache from file f (a missing file is an empty cache)
+    PackingCache(const char* f) : file(f) {
+        std::ifstream in(f);
+        Packing p;
+        while (in >> p.n >> p.s) {
+            p.x.resize(p.n); p.y.resize(p.n);
+            for (int i = 0; i < p.n; i++)
+                in >> p.x[i] >> p.y[i];
+            if (!in)
+                break;
+            packings[p.n] = p;
+        }
+    }
+
+    // Return the cached packing for n (NULL if there is none)
+    const Packing* find(int n) const {
+        std::map<int,Packing>::const_iterator i = packings.find(n);
+        return (i == packings.end()) ? NULL : &i->second;
+    }
+
+    // Narrow the bounds lo..hi for s of n using the cached entries
+    void bounds(int n, int& lo, int& hi) const {
+        for (std::map<int,Packing>::const_iterator i = packings.begin();
+             i != packings.end(); ++i) {
+            int m = i->first, s = i->second.s;
+            if (m < n) {
+                lo = std::max(lo, s);
+                // Squares m+1..n in a row next to the packing for m
+                hi = std::min(hi, s + (n*(n+1) - m*(m+1))/2);
+            } else if (m > n) {
+                hi = std::min(hi, s);
+            }
+        }
+    }
+
+    // Store packing p if it is new or better, and write the file
+    void store(const Packing& p) {
+        const Packing* q = find(p.n);
+        if ((q != NULL) && (q->s <= p.s))
+            return;
+        packings[p.n] = p;
+        std::ofstream out(file.c_str());
+        for (std::map<int,Packing>::const_iterator i = packings.begin();
+             i != packings.end(); ++i) {
+            out << i->second.n << ' ' << i->second.s;
+            for (int j = 0; j < i->second.n; j++)
+                out << ' ' << i->second.x[j] << ' ' << i->second.y[j];
+            out << '\n';
+        }
+    }
+};
+
+#endif
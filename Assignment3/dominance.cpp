@@ -0,0 +1,47 @@
+/*
+ * Empty strip dominance for square packing.
+ *
+ * A square of size k placed at distance g from a side of the enclosing
+ * square leaves a strip of width g that only smaller squares can use.
+ * For small enough g the squares in that strip can always be moved so
+ * that the square touches the side instead, so positions at distance g
+ * can be excluded.
+ *
+ * The limits are taken as given from the hand-written table the models
+ * used before, which ends at size 45. They are not derived here: moving
+ * the strip's squares along with the square only works if none of them
+ * sticks out of the strip at its ends, and for every size some filling
+ * does, so that check alone excludes nothing. Without a derivation there
+ * is nothing to extend the table with, and larger squares get no
+ * exclusion. The square of size 3 is the exception: it takes gap 3, not
+ * 2. Nothing is excluded for the square of size 1.
+ */
+
+#ifndef ASSIGNMENT3_DOMINANCE
+#define ASSIGNMENT3_DOMINANCE
+
+// Largest square size the limits are known for
+constexpr int stripKnown = 45;
+
+// Largest size of a square for which a gap of g (2 to 10) is dominated
+constexpr int strip(int g) {
+    return (g == 2) ? 4 : (g == 3) ? 8 : (g == 4) ? 11 : (g == 5) ? 17 :
+        (g == 6) ? 21 : (g == 7) ? 29 : (g == 8) ? 34 : (g == 9) ? 44 :
+        stripKnown;
+}
+
+// Gap excluded for a square of size k (0 if none), trying g upwards
+constexpr int stripGap(int k, int g = 2) {
+    return ((k <= 1) || (k > stripKnown)) ? 0 : (k == 3) ? 3 :
+        (k <= strip(g)) ? g : stripGap(k, g+1);
+}
+
+static_assert((stripGap(2) == 2) && (stripGap(4) == 2) &&
+              (stripGap(5) == 3) && (stripGap(8) == 3) &&
+              (stripGap(11) == 4) && (stripGap(17) == 5) &&
+              (stripGap(21) == 6) && (stripGap(29) == 7) &&
+              (stripGap(34) == 8) && (stripGap(44) == 9) &&
+              (stripGap(45) == 10) && (stripGap(46) == 0),
+              "empty strip table");
+
+#endif
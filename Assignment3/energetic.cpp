@@ -0,0 +1,182 @@
+/*
+ * Energetic reasoning for packing squares into an s x s square.
+ *
+ * For a window of the enclosing square, every square must put at least
+ * some area inside it, however it is placed within its bounds. If the
+ * sum of these areas exceeds the area of the window the space fails.
+ *
+ * Two kinds of windows are checked:
+ *  - strips [a,b) over the full height (and the same for y), with a and
+ *    b taken from the earliest starts and latest ends of the squares.
+ *    A strip has capacity (b-a)*s, so the check also raises s.min();
+ *  - rectangles spanned by the earliest start of one square and the
+ *    latest end of another, in both dimensions.
+ */
+
+#ifndef ASSIGNMENT3_ENERGETIC
+#define ASSIGNMENT3_ENERGETIC
+
+#include <gecode/int.hh>
+#include <algorithm>
+#include "../common/profile.cpp"
+
+using namespace Gecode;
+using namespace Gecode::Int;
+
+class Energetic : public Propagator {
+protected:
+    // The x-coordinates
+    ViewArray<IntView> x;
+    // The y-coordinates
+    ViewArray<IntView> y;
+    // The sizes (array)
+    int* w;
+    // The size of the enclosing square
+    IntView s;
+
+    // Least overlap of [v, v+k) with [a,b) for v in the bounds of p
+    static int overlap(const IntView& p, int k, int a, int b) {
+        int o = std::min(std::min(b-a, k),
+                         std::min(p.min()+k-a, b-p.max()));
+        return std::max(o, 0);
+    }
+
+    // Check the strips of one dimension and raise s.min()
+    ExecStatus strips(Space& home, ViewArray<IntView>& p, bool& modified) {
+        int n = p.size();
+        for (int i = 0; i < n; i++) {
+            int a = p[i].min();
+            for (int j = 0; j < n; j++) {
+                int b = p[j].max() + w[j];
+                if (b <= a)
+                    continue;
+                long long int e = 0;
+                for (int l = 0; l < n; l++)
+                    e += static_cast<long long int>(w[l]) *
+                        overlap(p[l], w[l], a, b);
+                if (e > static_cast<long long int>(b-a) * s.max())
+                    return ES_FAILED;
+                int least = static_cast<int>((e + (b-a) - 1) / (b-a));
+                if (least > s.min()) {
+                    if (me_failed(s.gq(home, least)))
+                        return ES_FAILED;
+                    modified = true;
+                }
+            }
+        }
+        return ES_OK;
+    }
+
+    // Check the rectangles spanned by pairs of squares
+    ExecStatus windows(void) const {
+        int n = x.size();
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                int a = x[i].min(), b = x[j].max() + w[j];
+                int c = y[i].min(), d = y[j].max() + w[j];
+                if ((b <= a) || (d <= c))
+                    continue;
+                long long int e = 0;
+                for (int l = 0; l < n; l++)
+                    e += static_cast<long long int>
+                        (overlap(x[l], w[l], a, b)) *
+                        overlap(y[l], w[l], c, d);
+                if (e > static_cast<long long int>(b-a) * (d-c))
+                    return ES_FAILED;
+            }
+        }
+        return ES_OK;
+    }
+public:
+    // Create propagator and initialize
+    Energetic(Home home, ViewArray<IntView>& x0, ViewArray<IntView>& y0,
+              int w0[], IntView s0)
+    : Propagator(home), x(x0), y(y0), w(w0), s(s0) {
+        x.subscribe(home,*this,PC_INT_BND);
+        y.subscribe(home,*this,PC_INT_BND);
+        s.subscribe(home,*this,PC_INT_BND);
+    }
+    // Post energetic propagator
+    static ExecStatus post(Home home,
+                           ViewArray<IntView>& x, ViewArray<IntView>& y,
+                           int w[], IntView s) {
+        if (x.size() > 0)
+            (void) new (home) Energetic(home,x,y,w,s);
+        return ES_OK;
+    }
+
+    // Copy constructor during cloning
+    Energetic(Space& home, bool share, Energetic& p)
+    : Propagator(home,share,p) {
+        x.update(home,share,p.x);
+        y.update(home,share,p.y);
+        s.update(home,share,p.s);
+        w = home.alloc<int>(x.size());
+        for (int i=x.size(); i--; )
+            w[i]=p.w[i];
+    }
+    // Create copy during cloning
+    virtual Propagator* copy(Space& home, bool share) {
+        return new (home) Energetic(home,share,*this);
+    }
+
+    // Return cost (cubic in the number of squares)
+    virtual PropCost cost(const Space&, const ModEventDelta&) const {
+        return PropCost::cubic(PropCost::LO,x.size());
+    }
+
+    // Perform propagation
+    virtual ExecStatus propagate(Space& home, const ModEventDelta&) {
+        PROFILE_SCOPE(prof, "Energetic::propagate");
+        PROFILE_MARK(prof, s.size());
+        bool modified = false;
+        if ((strips(home, x, modified) == ES_FAILED) ||
+            (strips(home, y, modified) == ES_FAILED) ||
+            (windows() == ES_FAILED)) {
+            PROFILE_FAILED(prof);
+            return ES_FAILED;
+        }
+        PROFILE_PRUNED(prof, s.size());
+
+        bool assigned = s.assigned();
+        for (int i = x.size(); assigned && i--; )
+            assigned = x[i].assigned() && y[i].assigned();
+        // With all squares placed there is nothing left to reason about
+        if (assigned)
+            return home.ES_SUBSUMED(*this);
+        // Raising s.min() can make more windows fail
+        return modified ? ES_NOFIX : ES_FIX;
+    }
+
+    // Dispose propagator and return its size
+    virtual size_t dispose(Space& home) {
+        x.cancel(home,*this,PC_INT_BND);
+        y.cancel(home,*this,PC_INT_BND);
+        s.cancel(home,*this,PC_INT_BND);
+        (void) Propagator::dispose(home);
+        return sizeof(*this);
+    }
+};
+
+/*
+ * Post energetic reasoning for the squares at x, y with sizes w inside
+ * the enclosing square of size s.
+ */
+void energetic(Home home, const IntVarArgs& x, const IntVarArgs& y,
+               const IntArgs& w, IntVar s) {
+    // Check whether the arguments make sense
+    if ((x.size() != y.size()) || (x.size() != w.size()))
+        throw ArgumentSizeMismatch("energetic");
+    // Never post a propagator in a failed space
+    if (home.failed()) return;
+    ViewArray<IntView> vx(home,x);
+    ViewArray<IntView> vy(home,y);
+    int* wc = static_cast<Space&>(home).alloc<int>(x.size());
+    for (int i=x.size(); i--; )
+        wc[i]=w[i];
+    // If posting failed, fail space
+    if (Energetic::post(home,vx,vy,wc,IntView(s)) != ES_OK)
+        home.fail();
+}
+
+#endif
@@ -0,0 +1,231 @@
+/*
+ * Leaving the smallest squares out of the model.
+ *
+ * The k smallest squares are not modelled at all: no coordinates, no
+ * pairwise constraints. Once the larger squares are placed, a filler
+ * looks for positions of the small ones in the cells left free, largest
+ * first and bottom-left first, backtracking over all positions. The
+ * search is exhaustive, so a leaf that cannot take the small squares
+ * fails and the model stays exact; print runs the filler again to show
+ * where they go.
+ *
+ * The squares left out still count for the area: the enclosing square
+ * must hold the area of all squares, so s starts at the least size that
+ * does. Without this, every placement of the larger squares at too
+ * small an s would be tried before the filler rejects it at the leaf.
+ *
+ * How many squares to leave out is given by -drop. square and
+ * square-IntervalCheck leave out the square of size 1 by default, as
+ * they always did, and square-noOverlapCheck models all squares. With
+ * -drop -1 it is decided by area: the smallest k go as long as their
+ * area fits into the waste of the smallest s whose area holds all
+ * squares. Then most placements of the larger squares leave enough room
+ * that the filler succeeds at its first attempt.
+ */
+
+#ifndef ASSIGNMENT3_FILLER
+#define ASSIGNMENT3_FILLER
+
+#include <gecode/int.hh>
+#include <vector>
+#include <cmath>
+#include "../common/profile.cpp"
+
+using namespace Gecode;
+using namespace Gecode::Int;
+
+// Number of the smallest of the squares of size n..1 to leave out
+int droppable(int n) {
+    if (n <= 1)
+        return 0;
+    long long int area = 0;
+    for (int i = 1; i <= n; i++)
+        area += static_cast<long long int>(i) * i;
+    long long int s = static_cast<long long int>(std::ceil(std::sqrt(
+        static_cast<double>(area))));
+    long long int waste = s*s - area, small = 1;
+    int k = 1;
+    while ((k+1 < n) && (small + (k+1)*(k+1) <= waste)) {
+        k++;
+        small += k*k;
+    }
+    return k;
+}
+
+// Free cells of an s x s square with some squares placed
+class Grid {
+protected:
+    int s;
+    std::vector<char> used;
+public:
+    Grid(int s0) : s(s0), used(s0*s0, 0) {}
+    // Whether a square of size w fits at x, y
+    bool fits(int x, int y, int w) const {
+        if ((x+w > s) || (y+w > s))
+            return false;
+        for (int i = y; i < y+w; i++)
+            for (int j = x; j < x+w; j++)
+                if (used[i*s+j])
+                    return false;
+        return true;
+    }
+    // Mark (v = 1) or clear (v = 0) the square of size w at x, y
+    void mark(int x, int y, int w, char v) {
+        for (int i = y; i < y+w; i++)
+            for (int j = x; j < x+w; j++)
+                used[i*s+j] = v;
+    }
+    /*
+     * Place the squares of size k..1 in the free cells, square k-j at
+     * fx[j], fy[j]. Returns false if they do not fit.
+     */
+    bool fill(int k, std::vector<int>& fx, std::vector<int>& fy) {
+        fx.resize(k); fy.resize(k);
+        return fill(k, 0, fx, fy);
+    }
+protected:
+    bool fill(int k, int j, std::vector<int>& fx, std::vector<int>& fy) {
+        if (j == k)
+            return true;
+        int w = k-j;
+        for (int y = 0; y+w <= s; y++)
+            for (int x = 0; x+w <= s; x++)
+                if (fits(x, y, w)) {
+                    mark(x, y, w, 1);
+                    bool ok = fill(k, j+1, fx, fy);
+                    mark(x, y, w, 0);
+                    if (ok) {
+                        fx[j] = x; fy[j] = y;
+                        return true;
+                    }
+                }
+        return false;
+    }
+};
+
+/*
+ * Place the squares of size k..1 into an s x s square next to the
+ * squares of size w[i] at x[i], y[i].
+ */
+bool fill(int s, int k, const std::vector<int>& w,
+          const std::vector<int>& x, const std::vector<int>& y,
+          std::vector<int>& fx, std::vector<int>& fy) {
+    Grid g(s);
+    for (size_t i = 0; i < w.size(); i++)
+        g.mark(x[i], y[i], w[i], 1);
+    return g.fill(k, fx, fy);
+}
+
+class Filler : public Propagator {
+protected:
+    // The x-coordinates
+    ViewArray<IntView> x;
+    // The y-coordinates
+    ViewArray<IntView> y;
+    // The sizes (array)
+    int* w;
+    // The size of the enclosing square
+    IntView s;
+    // Number of squares left out (of size k..1)
+    int k;
+public:
+    // Create propagator and initialize
+    Filler(Home home, ViewArray<IntView>& x0, ViewArray<IntView>& y0,
+           int w0[], IntView s0, int k0)
+    : Propagator(home), x(x0), y(y0), w(w0), s(s0), k(k0) {
+        x.subscribe(home,*this,PC_INT_VAL);
+        y.subscribe(home,*this,PC_INT_VAL);
+        s.subscribe(home,*this,PC_INT_VAL);
+    }
+    // Post filler propagator
+    static ExecStatus post(Home home,
+                           ViewArray<IntView>& x, ViewArray<IntView>& y,
+                           int w[], IntView s, int k) {
+        if (k > 0)
+            (void) new (home) Filler(home,x,y,w,s,k);
+        return ES_OK;
+    }
+
+    // Copy constructor during cloning
+    Filler(Space& home, bool share, Filler& p)
+    : Propagator(home,share,p), k(p.k) {
+        x.update(home,share,p.x);
+        y.update(home,share,p.y);
+        s.update(home,share,p.s);
+        w = home.alloc<int>(x.size());
+        for (int i=x.size(); i--; )
+            w[i]=p.w[i];
+    }
+    // Create copy during cloning
+    virtual Propagator* copy(Space& home, bool share) {
+        return new (home) Filler(home,share,*this);
+    }
+
+    // Return cost (only runs at the leaves)
+    virtual PropCost cost(const Space&, const ModEventDelta&) const {
+        return PropCost::linear(PropCost::HI,x.size());
+    }
+
+    // Perform propagation
+    virtual ExecStatus propagate(Space& home, const ModEventDelta&) {
+        if (!s.assigned())
+            return ES_FIX;
+        for (int i = x.size(); i--; )
+            if (!x[i].assigned() || !y[i].assigned())
+                return ES_FIX;
+        PROFILE_SCOPE(prof, "Filler::propagate");
+        Grid g(s.val());
+        for (int i = x.size(); i--; )
+            g.mark(x[i].val(), y[i].val(), w[i], 1);
+        std::vector<int> fx, fy;
+        if (!g.fill(k, fx, fy)) {
+            PROFILE_FAILED(prof);
+            return ES_FAILED;
+        }
+        return home.ES_SUBSUMED(*this);
+    }
+
+    // Dispose propagator and return its size
+    virtual size_t dispose(Space& home) {
+        x.cancel(home,*this,PC_INT_VAL);
+        y.cancel(home,*this,PC_INT_VAL);
+        s.cancel(home,*this,PC_INT_VAL);
+        (void) Propagator::dispose(home);
+        return sizeof(*this);
+    }
+};
+
+/*
+ * Post the filler for the squares of size k..1 next to the squares at
+ * x, y with sizes w inside the enclosing square of size s.
+ */
+void filler(Home home, const IntVarArgs& x, const IntVarArgs& y,
+            const IntArgs& w, IntVar s, int k) {
+    // Check whether the arguments make sense
+    if ((x.size() != y.size()) || (x.size() != w.size()))
+        throw ArgumentSizeMismatch("filler");
+    // Never post a propagator in a failed space
+    if (home.failed()) return;
+    // s*s must hold the area of all squares, the ones left out included
+    long long int area = static_cast<long long int>(k)*(k+1)*(2*k+1)/6;
+    for (int i = x.size(); i--; )
+        area += static_cast<long long int>(w[i]) * w[i];
+    long long int least = static_cast<long long int>(std::sqrt(
+        static_cast<double>(area)));
+    while (least*least < area)
+        least++;
+    if (me_failed(IntView(s).gq(home, static_cast<int>(least)))) {
+        home.fail();
+        return;
+    }
+    ViewArray<IntView> vx(home,x);
+    ViewArray<IntView> vy(home,y);
+    int* wc = static_cast<Space&>(home).alloc<int>(x.size());
+    for (int i=x.size(); i--; )
+        wc[i]=w[i];
+    // If posting failed, fail space
+    if (Filler::post(home,vx,vy,wc,IntView(s),k) != ES_OK)
+        home.fail();
+}
+
+#endif
@@ -0,0 +1,53 @@
+/*
+ * Greedy skyline packing of the squares of size n..1.
+ *
+ * The skyline keeps the height of every column of the enclosing square.
+ * Squares are placed largest first at the lowest position, leftmost on
+ * ties, that the skyline allows. Any packing it finds is a valid upper
+ * bound for s.
+ */
+
+#ifndef ASSIGNMENT3_GREEDY
+#define ASSIGNMENT3_GREEDY
+
+#include <vector>
+
+/*
+ * Try to pack the squares of size n..1 into an s x s square. On success
+ * x[i], y[i] is the position of the square of size n-i.
+ */
+bool skyline(int n, int s, std::vector<int>& x, std::vector<int>& y) {
+    std::vector<int> height(s, 0);
+    x.assign(n, 0); y.assign(n, 0);
+    for (int i = 0; i < n; i++) {
+        int k = n-i;
+        int bx = -1, by = s;
+        for (int c = 0; c+k <= s; c++) {
+            // the square rests on the highest column below it
+            int h = 0;
+            for (int j = c; j < c+k; j++)
+                if (height[j] > h)
+                    h = height[j];
+            if (h < by) {
+                by = h; bx = c;
+            }
+        }
+        if ((bx < 0) || (by+k > s))
+            return false;
+        for (int j = bx; j < bx+k; j++)
+            height[j] = by+k;
+        x[i] = bx; y[i] = by;
+    }
+    return true;
+}
+
+// Return the smallest s in lo..hi the skyline packs n squares into (hi if none)
+int greedy(int n, int lo, int hi) {
+    std::vector<int> x, y;
+    for (int s = lo; s < hi; s++)
+        if (skyline(n, s, x, y))
+            return s;
+    return hi;
+}
+
+#endif
@@ -26,56 +26,168 @@
  *
  */
 
+#ifndef ASSIGNMENT3_NO_OVERLAP
+#define ASSIGNMENT3_NO_OVERLAP
+
 #include <gecode/int.hh>
+#include <gecode/iter.hh>
+#include "../common/profile.cpp"
 
 using namespace Gecode;
 using namespace Gecode::Int;
 
+/*
+ * Sizes of the rectangles. The propagator is parameterized over one of
+ * these at compile time, so that squares keep a single size per item and
+ * constant sizes cost no subscriptions. w(i) and h(i) return the least
+ * width and height, which is all the pruning may rely on.
+ */
+
+// Squares of constant size
+class ConstSquare {
+protected:
+    // The sizes (array)
+    int* s;
+public:
+    ConstSquare(int* s0) : s(s0) {}
+    static const char* name(void) {
+        return "NoOverlap<ConstSquare>";
+    }
+    int w(int i) const { return s[i]; }
+    int h(int i) const { return s[i]; }
+    bool assigned(int) const { return true; }
+    void subscribe(Space&, Propagator&) {}
+    void cancel(Space&, Propagator&) {}
+    void update(Space& home, bool, ConstSquare& o, int n) {
+        s = home.alloc<int>(n);
+        for (int i=n; i--; )
+            s[i]=o.s[i];
+    }
+};
+
+// Rectangles of constant width and height
+class ConstRect {
+protected:
+    // The widths and heights (arrays)
+    int* wd;
+    int* ht;
+public:
+    ConstRect(int* w0, int* h0) : wd(w0), ht(h0) {}
+    static const char* name(void) {
+        return "NoOverlap<ConstRect>";
+    }
+    int w(int i) const { return wd[i]; }
+    int h(int i) const { return ht[i]; }
+    bool assigned(int) const { return true; }
+    void subscribe(Space&, Propagator&) {}
+    void cancel(Space&, Propagator&) {}
+    void update(Space& home, bool, ConstRect& o, int n) {
+        wd = home.alloc<int>(n);
+        ht = home.alloc<int>(n);
+        for (int i=n; i--; ) {
+            wd[i]=o.wd[i]; ht[i]=o.ht[i];
+        }
+    }
+};
+
+// Squares whose size is a variable
+class VarSquare {
+protected:
+    ViewArray<IntView> s;
+public:
+    VarSquare(const ViewArray<IntView>& s0) : s(s0) {}
+    static const char* name(void) {
+        return "NoOverlap<VarSquare>";
+    }
+    int w(int i) const { return s[i].min(); }
+    int h(int i) const { return s[i].min(); }
+    bool assigned(int i) const { return s[i].assigned(); }
+    void subscribe(Space& home, Propagator& p) {
+        s.subscribe(home,p,PC_INT_BND);
+    }
+    void cancel(Space& home, Propagator& p) {
+        s.cancel(home,p,PC_INT_BND);
+    }
+    void update(Space& home, bool share, VarSquare& o, int) {
+        s.update(home,share,o.s);
+    }
+};
+
+// Rectangles whose width and height are variables
+class VarRect {
+protected:
+    ViewArray<IntView> wd;
+    ViewArray<IntView> ht;
+public:
+    VarRect(const ViewArray<IntView>& w0, const ViewArray<IntView>& h0)
+    : wd(w0), ht(h0) {}
+    static const char* name(void) {
+        return "NoOverlap<VarRect>";
+    }
+    int w(int i) const { return wd[i].min(); }
+    int h(int i) const { return ht[i].min(); }
+    bool assigned(int i) const {
+        return wd[i].assigned() && ht[i].assigned();
+    }
+    void subscribe(Space& home, Propagator& p) {
+        wd.subscribe(home,p,PC_INT_BND);
+        ht.subscribe(home,p,PC_INT_BND);
+    }
+    void cancel(Space& home, Propagator& p) {
+        wd.cancel(home,p,PC_INT_BND);
+        ht.cancel(home,p,PC_INT_BND);
+    }
+    void update(Space& home, bool share, VarRect& o, int) {
+        wd.update(home,share,o.wd);
+        ht.update(home,share,o.ht);
+    }
+};
+
 // The no-overlap propagator
+template<class Size>
 class NoOverlap : public Propagator {
 protected:
     // The x-coordinates
     ViewArray<IntView> x;
-    // The width (array)
-    int* w;
     // The y-coordinates
     ViewArray<IntView> y;
-    // The heights (array)
-    int* h;
+    // The widths and heights
+    Size sz;
+
+    // Whether rectangle i is placed
+    bool placed(int i) const {
+        return x[i].assigned() && y[i].assigned() && sz.assigned(i);
+    }
 public:
     // Create propagator and initialize
     NoOverlap(Home home,
-              ViewArray<IntView>& x0, int w0[],
-              ViewArray<IntView>& y0, int h0[])
-    : Propagator(home), x(x0), w(w0), y(y0), h(h0) {
+              ViewArray<IntView>& x0, ViewArray<IntView>& y0, Size sz0)
+    : Propagator(home), x(x0), y(y0), sz(sz0) {
         x.subscribe(home,*this,PC_INT_BND);
         y.subscribe(home,*this,PC_INT_BND);
+        sz.subscribe(home,*this);
     }
     // Post no-overlap propagator
     static ExecStatus post(Home home,
-                           ViewArray<IntView>& x, int w[],
-                           ViewArray<IntView>& y, int h[]) {
+                           ViewArray<IntView>& x, ViewArray<IntView>& y,
+                           Size sz) {
         // Only if there is something to propagate
         if (x.size() > 1)
-            (void) new (home) NoOverlap(home,x,w,y,h);
+            (void) new (home) NoOverlap<Size>(home,x,y,sz);
         return ES_OK;
     }
     
     // Copy constructor during cloning
-    NoOverlap(Space& home, bool share, NoOverlap& p)
-    : Propagator(home,share,p) {
+    NoOverlap(Space& home, bool share, NoOverlap<Size>& p)
+    : Propagator(home,share,p), sz(p.sz) {
         x.update(home,share,p.x);
         y.update(home,share,p.y);
-        // Also copy width and height arrays
-        w = home.alloc<int>(x.size());
-        h = home.alloc<int>(y.size());
-        for (int i=x.size(); i--; ) {
-            w[i]=p.w[i]; h[i]=p.h[i];
-        }
+        // Also copy the sizes
+        sz.update(home,share,p.sz,x.size());
     }
     // Create copy during cloning
     virtual Propagator* copy(Space& home, bool share) {
-        return new (home) NoOverlap(home,share,*this);
+        return new (home) NoOverlap<Size>(home,share,*this);
     }
     
     // Return cost (defined as cheap quadratic)
@@ -83,41 +195,116 @@ public:
         return PropCost::quadratic(PropCost::LO,2*x.size());
     }
     
+    // Sum of the domain sizes (used for profiling prunings)
+    unsigned long int domsize(void) const {
+        unsigned long int d = 0;
+        for (int i = x.size(); i--; )
+            d += x[i].size() + y[i].size();
+        return d;
+    }
+    
     // Perform propagation
     virtual ExecStatus propagate(Space& home, const ModEventDelta&) {
+        PROFILE_SCOPE(prof, Size::name());
+        PROFILE_MARK(prof, domsize());
+        
+        int n = x.size();
+        // Copy bounds and sizes into flat arrays, so that the test of
+        // one placed rectangle against all others is a tight loop
+        Region r(home);
+        int* xmin = r.alloc<int>(n); int* xmax = r.alloc<int>(n);
+        int* ymin = r.alloc<int>(n); int* ymax = r.alloc<int>(n);
+        int* w = r.alloc<int>(n); int* h = r.alloc<int>(n);
+        bool* fixed = r.alloc<bool>(n);
+        int* side = r.alloc<int>(n);
+        for (int j = 0; j < n; j++) {
+            xmin[j] = x[j].min(); xmax[j] = x[j].max();
+            ymin[j] = y[j].min(); ymax[j] = y[j].max();
+            w[j] = sz.w(j); h[j] = sz.h(j);
+            fixed[j] = placed(j);
+        }
         
         int countAssigned = 0;
+        bool modified = false;
         
-        for (int i = 0; i < x.size(); i++) {
-            if (x[i].assigned() && y[i].assigned()) {
-                // Count the assigned x,y pairs
-                countAssigned++;
-                for (int j = i+1; j < x.size(); j++) {
-                    
-                    // If j overlaps with i return failure
-                    // otherwise the values that conflict are removed.
-                    if (    me_failed(x[j].lq(home, x[i].val()-w[j]))
-                        &&  me_failed(x[j].gq(home, x[i].val()+w[i]))
-                        &&  me_failed(y[j].lq(home, y[i].val()-h[j]))
-                        &&  me_failed(y[j].gq(home, y[i].val()+h[i]))) {
-                        return ES_FAILED;
+        for (int i = 0; i < n; i++) {
+            if (!fixed[i])
+                continue;
+            // Count the placed rectangles
+            countAssigned++;
+            int xi = x[i].val(), yi = y[i].val();
+            int wi = w[i], hi = h[i];
+            
+            // Each bit says j can still be left of, right of, below or
+            // above i
+            for (int j = 0; j < n; j++)
+                side[j] = ((xmin[j] + w[j] <= xi)     ) |
+                          ((xmax[j] >= xi + wi)  << 1) |
+                          ((ymin[j] + h[j] <= yi) << 2) |
+                          ((ymax[j] >= yi + hi)  << 3);
+            
+            for (int j = 0; j < n; j++) {
+                // Pairs of placed rectangles are only checked once
+                if ((j == i) || (fixed[j] && (j < i)))
+                    continue;
+                ModEvent me = ME_INT_NONE;
+                switch (side[j]) {
+                case 0:
+                    // j overlaps with i wherever it goes
+                    PROFILE_FAILED(prof);
+                    return ES_FAILED;
+                case 1:
+                    me = x[j].lq(home, xi - w[j]); break;
+                case 2:
+                    me = x[j].gq(home, xi + wi); break;
+                case 4:
+                    me = y[j].lq(home, yi - h[j]); break;
+                case 8:
+                    me = y[j].gq(home, yi + hi); break;
+                case 3:
+                    {
+                        // j is left or right of i: remove the values between
+                        Iter::Ranges::Singleton between(xi - w[j] + 1, xi + wi - 1);
+                        me = x[j].minus_r(home, between, false);
                     }
+                    break;
+                case 12:
+                    {
+                        // j is below or above i: remove the values between
+                        Iter::Ranges::Singleton between(yi - h[j] + 1, yi + hi - 1);
+                        me = y[j].minus_r(home, between, false);
+                    }
+                    break;
+                default:
+                    // j can still be on more than one side
+                    break;
+                }
+                if (me_failed(me)) {
+                    PROFILE_FAILED(prof);
+                    return ES_FAILED;
+                }
+                if (me_modified(me)) {
+                    modified = true;
+                    xmin[j] = x[j].min(); xmax[j] = x[j].max();
+                    ymin[j] = y[j].min(); ymax[j] = y[j].max();
                 }
             }
         }
+        PROFILE_PRUNED(prof, domsize());
         
         // When all the variables are assigned, return subsumption
-        // Otherwise the propagator is at fixpoint
-        if(countAssigned == x.size())
+        if(countAssigned == n)
             return home.ES_SUBSUMED(*this);
         
-        return ES_FIX;
+        // Rectangles placed by this propagation are only used next time
+        return modified ? ES_NOFIX : ES_FIX;
     }
     
     // Dispose propagator and return its size
     virtual size_t dispose(Space& home) {
         x.cancel(home,*this,PC_INT_BND);
         y.cancel(home,*this,PC_INT_BND);
+        sz.cancel(home,*this);
         (void) Propagator::dispose(home);
         return sizeof(*this);
     }
@@ -142,14 +329,57 @@ void nooverlap(Home home,
     // Set up array of views for the coordinates
     ViewArray<IntView> vx(home,x);
     ViewArray<IntView> vy(home,y);
+    // Squares only need one size per item
+    bool square = true;
+    for (int i=x.size(); i--; )
+        square = square && (w[i] == h[i]);
     // Set up arrays (allocated in home) for width and height and initialize
     int* wc = static_cast<Space&>(home).alloc<int>(x.size());
-    int* hc = static_cast<Space&>(home).alloc<int>(y.size());
+    int* hc = square ? wc : static_cast<Space&>(home).alloc<int>(y.size());
     for (int i=x.size(); i--; ) {
         wc[i]=w[i]; hc[i]=h[i];
     }
+    ExecStatus es = square ?
+        NoOverlap<ConstSquare>::post(home,vx,vy,ConstSquare(wc)) :
+        NoOverlap<ConstRect>::post(home,vx,vy,ConstRect(wc,hc));
     // If posting failed, fail space
-    if (NoOverlap::post(home,vx,wc,vy,hc) != ES_OK)
+    if (es != ES_OK)
+        home.fail();
+}
+
+// Post no-overlap for squares of size s at x and y
+void nooverlap(Home home,
+               const IntVarArgs& x, const IntVarArgs& y, const IntArgs& s) {
+    nooverlap(home, x, s, y, s);
+}
+
+// Post no-overlap for rectangles whose width and height are variables
+void nooverlap(Home home,
+               const IntVarArgs& x, const IntVarArgs& w,
+               const IntVarArgs& y, const IntVarArgs& h) {
+    if ((x.size() != y.size()) || (x.size() != w.size()) ||
+        (y.size() != h.size()))
+        throw ArgumentSizeMismatch("nooverlap");
+    if (home.failed()) return;
+    ViewArray<IntView> vx(home,x);
+    ViewArray<IntView> vy(home,y);
+    ViewArray<IntView> vw(home,w);
+    ViewArray<IntView> vh(home,h);
+    if (NoOverlap<VarRect>::post(home,vx,vy,VarRect(vw,vh)) != ES_OK)
+        home.fail();
+}
+
+// Post no-overlap for squares whose size s is a variable
+void nooverlap(Home home,
+               const IntVarArgs& x, const IntVarArgs& y, const IntVarArgs& s) {
+    if ((x.size() != y.size()) || (x.size() != s.size()))
+        throw ArgumentSizeMismatch("nooverlap");
+    if (home.failed()) return;
+    ViewArray<IntView> vx(home,x);
+    ViewArray<IntView> vy(home,y);
+    ViewArray<IntView> vs(home,s);
+    if (NoOverlap<VarSquare>::post(home,vx,vy,VarSquare(vs)) != ES_OK)
         home.fail();
 }
 
+#endif
@@ -0,0 +1,315 @@
+/*
+ * Differential check of the custom packing propagators and branchers.
+ *
+ * Random instances (items of small sizes to pack into a fixed s x s
+ * square) are solved for all solutions with every variant below. The
+ * pairwise decomposition from square.cpp with plain branching is the
+ * reference: every other variant must find exactly the same solutions,
+ * each of them once. Nodes and time are reported relative to the
+ * reference, so a change that speeds things up by pruning wrongly, or
+ * that branches into the same solution twice, shows up as a mismatch.
+ *
+ * The instances take turns over the four kinds of items NoOverlap is
+ * instantiated for: squares and rectangles, of constant size or with
+ * sizes that are variables ranging over one less than their largest
+ * size up to it. Variants that only handle some kinds skip the others.
+ *
+ * The program prints every mismatching instance and exits with 1 if
+ * there is one.
+ */
+
+#include <gecode/driver.hh>
+#include <gecode/int.hh>
+#include <gecode/minimodel.hh>
+#include <gecode/search.hh>
+#include "no-overlap.cpp"
+#include "energetic.cpp"
+#include "bottom-left.cpp"
+#include "../Assignment4/interval.cpp"
+#include <vector>
+#include <set>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+
+using namespace Gecode;
+
+// The kinds of items, one per instantiation of NoOverlap
+enum {
+    CONST_SQUARE,   // squares of constant size
+    CONST_RECT,     // rectangles of constant width and height
+    VAR_SQUARE,     // squares whose size is a variable
+    VAR_RECT,       // rectangles whose width and height are variables
+    KINDS
+};
+
+static const char* kinds[KINDS] = {
+    "const square", "const rect", "var square", "var rect"
+};
+
+/*
+ * Items of width w[i] and height h[i] to pack into an s x s square. With
+ * variable sizes, w[i] and h[i] are the largest sizes and the smallest
+ * are one less (but at least 1).
+ */
+class Instance {
+public:
+    int kind;
+    int s;
+    std::vector<int> w, h;
+    // Whether the sizes are variables
+    bool var(void) const {
+        return (kind == VAR_SQUARE) || (kind == VAR_RECT);
+    }
+    // Whether the items are squares
+    bool square(void) const {
+        return (kind == CONST_SQUARE) || (kind == VAR_SQUARE);
+    }
+};
+
+std::ostream& operator<<(std::ostream& os, const Instance& in) {
+    os << kinds[in.kind] << ", s = " << in.s << ", sizes =";
+    for (size_t i = 0; i < in.w.size(); i++) {
+        os << " " << in.w[i];
+        if (!in.square())
+            os << "x" << in.h[i];
+    }
+    if (in.var())
+        os << " (or one less)";
+    return os;
+}
+
+// The variants compared
+enum {
+    DECOMPOSITION,  // reified pairwise decomposition (reference)
+    NOOVERLAP,      // NoOverlap propagator
+    ENERGETIC,      // NoOverlap plus energetic reasoning
+    INTERVAL,       // decomposition with interval branching first
+    BOTTOMLEFT,     // decomposition with bottom-left placement first
+    VARIANTS
+};
+
+static const char* names[VARIANTS] = {
+    "decomposition", "nooverlap", "energetic", "interval", "bottomleft"
+};
+
+// Whether variant v handles the items of instance in
+bool handles(int v, const Instance& in) {
+    switch (v) {
+    case ENERGETIC:
+    case BOTTOMLEFT: return in.kind == CONST_SQUARE;
+    case INTERVAL:  return !in.var();
+    default:        return true;
+    }
+}
+
+class Fuzz : public Space {
+public:
+    IntVarArray x;  // x axis
+    IntVarArray y;  // y axis
+    IntVarArray w;  // widths
+    IntVarArray h;  // heights (the widths for squares)
+
+    Fuzz(const Instance& in, int variant)
+    : x(*this, in.w.size(), 0, in.s), y(*this, in.w.size(), 0, in.s),
+      w(*this, in.w.size()), h(*this, in.w.size()) {
+        int n = in.w.size();
+        IntArgs cw(n), ch(n);
+        for (int i = 0; i < n; i++) {
+            cw[i] = in.w[i]; ch[i] = in.h[i];
+            int d = in.var() ? 1 : 0;
+            w[i] = IntVar(*this, std::max(1, cw[i]-d), cw[i]);
+            h[i] = in.square() ? w[i] :
+                IntVar(*this, std::max(1, ch[i]-d), ch[i]);
+        }
+
+        // items must be inside the enclosing square
+        for (int i = 0; i < n; i++) {
+            rel(*this, (x[i] + w[i]) <= in.s);
+            rel(*this, (y[i] + h[i]) <= in.s);
+        }
+
+        if ((variant == DECOMPOSITION) || (variant == INTERVAL) ||
+            (variant == BOTTOMLEFT)) {
+            // s1 is left of s2 or s2 is left of s1 or
+            // s1 is above s2 or s2 is above s1
+            for (int i = 0; i < n; i++) {
+                for (int j = i+1; j < n; j++) {
+                    rel(*this, (x[i] + w[i] <= x[j]) ||
+                               (x[j] + w[j] <= x[i]) ||
+                               (y[i] + h[i] <= y[j]) ||
+                               (y[j] + h[j] <= y[i]));
+                }
+            }
+        } else {
+            // the instantiation of NoOverlap for the kind of items
+            switch (in.kind) {
+            case CONST_SQUARE: nooverlap(*this, x, y, cw); break;
+            case CONST_RECT:   nooverlap(*this, x, cw, y, ch); break;
+            case VAR_SQUARE:   nooverlap(*this, x, y, w); break;
+            case VAR_RECT:     nooverlap(*this, x, w, y, h); break;
+            }
+            if (variant == ENERGETIC)
+                energetic(*this, x, y, cw, IntVar(*this, in.s, in.s));
+        }
+
+        if (variant == INTERVAL) {
+            interval(*this, x, cw, 0.5);
+            interval(*this, y, ch, 0.5);
+        }
+        if (variant == BOTTOMLEFT)
+            bottomleft(*this, x, y, cw, IntVar(*this, in.s, in.s));
+        branch(*this, x, INT_VAR_NONE(), INT_VAL_MIN());
+        branch(*this, y, INT_VAR_NONE(), INT_VAL_MIN());
+        branch(*this, w, INT_VAR_NONE(), INT_VAL_MIN());
+        branch(*this, h, INT_VAR_NONE(), INT_VAL_MIN());
+    }
+
+    /// Constructor for cloning
+    Fuzz(bool share, Fuzz& f) : Space(share,f) {
+        x.update(*this, share, f.x);
+        y.update(*this, share, f.y);
+        w.update(*this, share, f.w);
+        h.update(*this, share, f.h);
+    }
+
+    /// Perform copying during cloning
+    virtual Space*
+    copy(bool share) {
+        return new Fuzz(share,*this);
+    }
+
+    // The solution as x positions, y positions, widths and heights
+    std::vector<int> solution(void) const {
+        std::vector<int> v;
+        for (int i = 0; i < x.size(); i++)
+            v.push_back(x[i].val());
+        for (int i = 0; i < y.size(); i++)
+            v.push_back(y[i].val());
+        for (int i = 0; i < w.size(); i++)
+            v.push_back(w[i].val());
+        for (int i = 0; i < h.size(); i++)
+            v.push_back(h[i].val());
+        return v;
+    }
+};
+
+// Solutions, nodes and time of one variant on one instance
+class Result {
+public:
+    std::set<std::vector<int> > solutions;
+    // Solutions found, more than solutions.size() if some came twice
+    unsigned long int found;
+    unsigned long int nodes;
+    double ms;
+};
+
+Result solve(const Instance& in, int variant) {
+    Result r;
+    r.found = 0;
+    std::chrono::steady_clock::time_point t = std::chrono::steady_clock::now();
+    DFS<Fuzz> e(new Fuzz(in, variant));
+    while (Fuzz* f = e.next()) {
+        r.solutions.insert(f->solution());
+        r.found++;
+        delete f;
+    }
+    r.nodes = e.statistics().node;
+    r.ms = std::chrono::duration_cast<std::chrono::microseconds>
+        (std::chrono::steady_clock::now() - t).count() / 1000.0;
+    return r;
+}
+
+class FuzzOptions : public SizeOptions {
+protected:
+    // Seed of the random instances (-seed is Gecode's own option)
+    Driver::UnsignedIntOption _fuzz_seed;
+    // Largest number of items in an instance
+    Driver::UnsignedIntOption _squares;
+public:
+    FuzzOptions(const char* s)
+    : SizeOptions(s),
+      _fuzz_seed("-fuzz-seed", "seed for the random instances", 1),
+      _squares("-squares", "largest number of items per instance", 5) {
+        add(_fuzz_seed);
+        add(_squares);
+    }
+    unsigned int fuzz_seed(void) const {
+        return _fuzz_seed.value();
+    }
+    unsigned int squares(void) const {
+        return _squares.value();
+    }
+};
+
+int main(int argc, char* argv[]) {
+    FuzzOptions opt("Square fuzz");
+    // the size is the number of instances
+    opt.size(200);
+    opt.parse(argc,argv);
+
+    std::mt19937 rng(opt.fuzz_seed());
+    std::uniform_int_distribution<int> count(2, std::max(2, (int) opt.squares()));
+    std::uniform_int_distribution<int> size(1, 4);
+    std::uniform_int_distribution<int> slack(0, 2);
+
+    unsigned long int nodes[VARIANTS] = {0};
+    // Nodes of the reference on the instances a variant handles
+    unsigned long int base[VARIANTS] = {0};
+    double ms[VARIANTS] = {0.0};
+    double basems[VARIANTS] = {0.0};
+    unsigned int runs[VARIANTS] = {0};
+    int mismatches = 0;
+
+    for (unsigned int k = 0; k < opt.size(); k++) {
+        Instance in;
+        in.kind = k % KINDS;
+        int area = 0, largest = 0;
+        in.w.resize(count(rng));
+        in.h.resize(in.w.size());
+        for (size_t i = 0; i < in.w.size(); i++) {
+            in.w[i] = size(rng);
+            in.h[i] = in.square() ? in.w[i] : size(rng);
+            area += in.w[i]*in.h[i];
+            largest = std::max(largest, std::max(in.w[i], in.h[i]));
+        }
+        in.s = std::max(largest, (int) ceil(sqrt((double) area))) + slack(rng);
+
+        Result ref = solve(in, DECOMPOSITION);
+        for (int v = DECOMPOSITION; v < VARIANTS; v++) {
+            if (!handles(v, in))
+                continue;
+            Result r = (v == DECOMPOSITION) ? ref : solve(in, v);
+            nodes[v] += r.nodes; base[v] += ref.nodes;
+            ms[v] += r.ms; basems[v] += ref.ms;
+            runs[v]++;
+            if ((r.solutions != ref.solutions) ||
+                (r.found != r.solutions.size())) {
+                mismatches++;
+                std::cout << "Mismatch in instance " << k << " (" << in
+                          << "): " << names[v] << " finds "
+                          << r.solutions.size() << " solutions ("
+                          << r.found << " in all), "
+                          << names[DECOMPOSITION] << " finds "
+                          << ref.solutions.size() << std::endl;
+            }
+        }
+    }
+
+    std::cout << std::endl << "Summary (" << opt.size() << " instances, seed "
+              << opt.fuzz_seed() << ")" << std::endl;
+    for (int v = 0; v < VARIANTS; v++) {
+        std::cout << "\t" << std::left << std::setw(14) << names[v]
+                  << std::right << " instances: " << std::setw(5) << runs[v]
+                  << " nodes: " << std::setw(10) << nodes[v]
+                  << " (" << std::fixed << std::setprecision(2)
+                  << (double) nodes[v] / std::max(1ul, base[v])
+                  << ")  time: " << std::setprecision(3) << ms[v] << " ms ("
+                  << std::setprecision(2)
+                  << ms[v] / std::max(1e-3, basems[v]) << ")"
+                  << std::endl;
+    }
+    std::cout << "\tmismatches:    " << mismatches << std::endl;
+    return (mismatches == 0) ? 0 : 1;
+}
@@ -0,0 +1,188 @@
+/*
+ * What the square packing models have in common.
+ *
+ * SquareModel holds the enclosing square s and the positions of the
+ * modelled squares, reports s as the objective, and prints a packing of
+ * all n squares, the ones left to the filler included. A model derives
+ * from it and only posts its own constraints and branching.
+ *
+ * squareMain reads n, narrows the bounds for s from the cache and the
+ * greedy packing and runs the model. It is the main function of every
+ * square model. With a cache the packing is stored once the search
+ * returns with it proven optimal, never from print, which also shows
+ * incumbents cut off by a deadline.
+ */
+
+#ifndef ASSIGNMENT3_SQUARE_MODEL
+#define ASSIGNMENT3_SQUARE_MODEL
+
+#include <gecode/driver.hh>
+#include <gecode/int.hh>
+#include <gecode/minimodel.hh>
+#include <vector>
+#include <cmath>
+#include "square-options.cpp"
+#include "cache.cpp"
+#include "greedy.cpp"
+#include "filler.cpp"
+#include "../common/profile.cpp"
+
+using namespace Gecode;
+
+int n;
+// number of squares in the model, the smaller ones are left to the filler
+int m;
+// bounds for s
+int smin, smax;
+// cache of optimal packings (NULL if not used)
+PackingCache* cache = NULL;
+
+class SquareModel : public Script, public Objective {
+public:
+
+    IntVar s;       // size of square (w=h)
+    IntVarArray x;  // x axis
+    IntVarArray y;  // y axis
+
+    // The smallest squares are ignored (by using i < m in the models)
+    SquareModel(const SquareOptions& opt)
+    : Script(opt), s(*this, smin, smax),
+      x(*this, m, 0, smax), y(*this, m, 0, smax) {}
+
+    /// Constructor for cloning
+    SquareModel(bool share, SquareModel& sq) : Script(share,sq) {
+        x.update(*this, share, sq.x);
+        y.update(*this, share, sq.y);
+        s.update(*this, share, sq.s);
+    }
+
+    // size of the enclosing square in a solution
+    virtual int objective(void) const {
+        return s.val();
+    }
+
+    // no packing in this space fits a square smaller than s.min()
+    virtual int bound(void) const {
+        return s.min();
+    }
+
+    virtual bool minimise(void) const {
+        return true;
+    }
+
+    // squares of size up to smax are known to fit all n squares
+    virtual bool known(int& v) const {
+        v = smax;
+        return true;
+    }
+
+    //returns the size of square i
+    static int size(int i){
+        return n-i;
+    }
+
+    // returns the sum of all square sizes
+    static int sum(int n){
+        int sum = 0;
+        for(int i=0; i<n; i++){
+            sum += n-i;
+        }
+        return sum;
+    }
+
+    // Positions of all n squares, the ones left out from the filler
+    void positions(std::vector<int>& px, std::vector<int>& py) const {
+        std::vector<int> w(m), fx, fy;
+        px.resize(m); py.resize(m);
+        for (int i = 0; i < m; i++) {
+            w[i] = size(i); px[i] = x[i].val(); py[i] = y[i].val();
+        }
+        (void) fill(s.val(), n-m, w, px, py, fx, fy);
+        px.insert(px.end(), fx.begin(), fx.end());
+        py.insert(py.end(), fy.begin(), fy.end());
+    }
+
+    /// Print solution
+    virtual void print(std::ostream& os) const {
+        std::vector<int> px, py;
+        positions(px, py);
+        Sink::Timer timer;
+        if (Sink::compact()) {
+            os << s.val();
+            for (int i = 0; i < n; i++)
+                os << ' ' << px[i] << ' ' << py[i];
+            os << '\n';
+            return;
+        }
+        os << "\t";
+        os << "Smallest S = " << s << "\n\t";
+        os << "For N = " << n << "\n\t";
+        for (int i = 0; i < n; i++) {
+            os << "square with size " << size(i) << "\tPosition: " << px[i] << "," << py[i];
+            os << "\n\t";
+        }
+        os << '\n';
+    }
+
+};
+
+/*
+ * Main function of the square model Model, leaving the drop smallest
+ * squares to the filler unless -drop says otherwise.
+ */
+template<class Model>
+int squareMain(int argc, char* argv[], int drop) {
+    SquareOptions opt("Square");
+    int in;
+    std::cout << "Please enter the number of squares to pack" << std::endl;
+    std::cin >> in;
+    while(std::cin.fail() || in < 0) {
+        std::cout << "Invalid input, please enter a positive integer" << std::endl;
+        std::cin.clear();
+        std::cin.ignore(256,'\n');
+        std::cin >> in;
+    }
+    opt.size(in);
+    n = opt.size();
+    opt.drop(drop);
+    opt.parse(argc,argv);
+    m = n - ((opt.drop() >= 0) ? std::min(opt.drop(), std::max(n-1, 0))
+                               : droppable(n));
+
+    smin = floor(sqrt(n*(n+1)*(2*n+1)/6));
+    smax = SquareModel::sum(n);
+    if (opt.cache() != NULL) {
+        cache = new PackingCache(opt.cache());
+        // repeated queries are answered from the cache
+        if (const Packing* p = cache->find(n)) {
+            p->print(std::cout);
+            return 0;
+        }
+        cache->bounds(n, smin, smax);
+    }
+    // a greedy packing is a much better upper bound than sum(n)
+    smax = greedy(n, smin, smax);
+    // with a deadline the greedy packing is the incumbent to beat
+    if (opt.deadline() > 0) {
+        Packing p(n, smax);
+        if (skyline(n, smax, p.x, p.y))
+            p.print(std::cout, "greedy");
+    }
+
+    Profile::start();
+    if (cache != NULL) {
+        // only a packing the search proved optimal goes into the cache
+        if (Model* sq = solveOptimal<Model,DFS>(opt)) {
+            Packing p(n, sq->s.val());
+            sq->positions(p.x, p.y);
+            cache->store(p);
+            delete sq;
+        }
+    } else {
+        solve<Model,DFS>(opt);
+    }
+    Profile::print(std::cout);
+    return 0;
+}
+
+#endif
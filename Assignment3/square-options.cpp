@@ -0,0 +1,56 @@
+/*
+ * Options shared by the square packing models.
+ */
+
+#ifndef ASSIGNMENT3_SQUARE_OPTIONS
+#define ASSIGNMENT3_SQUARE_OPTIONS
+
+#include "../common/engine.cpp"
+
+// Propagation variants
+enum {
+    PROP_PLAIN,     // the model's own constraints only
+    PROP_ENERGETIC  // plus energetic reasoning on the x/y domains
+};
+
+// Branching variants
+enum {
+    BRANCH_XY,          // all x, then all y, smallest value first
+    BRANCH_BOTTOMLEFT   // squares on the lowest, leftmost free cell
+};
+
+class SquareOptions : public EngineOptions {
+protected:
+    // File of cached optimal packings
+    Driver::StringValueOption _cache;
+    // Number of smallest squares left to the filler (-1 to decide by area)
+    Driver::IntOption _drop;
+public:
+    SquareOptions(const char* s)
+    : EngineOptions(s),
+      _cache("-cache", "file of cached optimal packings"),
+      _drop("-drop", "smallest squares left to the filler "
+            "(-1 to decide by area)", -1) {
+        add(_cache);
+        add(_drop);
+        propagation(PROP_PLAIN, "plain", "model constraints only");
+        propagation(PROP_ENERGETIC, "energetic",
+                    "add energetic reasoning");
+        propagation(PROP_PLAIN);
+        branching(BRANCH_XY, "xy", "all x, then all y");
+        branching(BRANCH_BOTTOMLEFT, "bottomleft",
+                  "place squares on the lowest, leftmost free cell");
+        branching(BRANCH_XY);
+    }
+    const char* cache(void) const {
+        return _cache.value();
+    }
+    int drop(void) const {
+        return _drop.value();
+    }
+    void drop(int v) {
+        _drop.value(v);
+    }
+};
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ * Life boards outside of a space.
+ *
+ * A board is the n x n interior row by row, 1 for alive; everything
+ * outside it is dead. These helpers check and print boards that were
+ * put together without the Life model, such as tiled solutions.
+ */
+
+#ifndef ASSIGNMENT4_BOARD
+#define ASSIGNMENT4_BOARD
+
+#include <vector>
+#include <iostream>
+#include "../common/sink.cpp"
+
+// Value of cell (r,c) of the n x n board b (dead outside)
+inline int cell(const std::vector<char>& b, int n, int r, int c) {
+    return ((r >= 0) && (c >= 0) && (r < n) && (c < n)) ? b[r*n+c] : 0;
+}
+
+// Whether board b is a still life, including the dead cells around it
+bool stillLife(const std::vector<char>& b, int n) {
+    for (int r = -1; r <= n; r++)
+        for (int c = -1; c <= n; c++) {
+            int s = 0;
+            for (int i = r-1; i <= r+1; i++)
+                for (int j = c-1; j <= c+1; j++)
+                    if ((i != r) || (j != c))
+                        s += cell(b, n, i, j);
+            if (cell(b, n, r, c) ? ((s < 2) || (s > 3)) : (s == 3))
+                return false;
+        }
+    return true;
+}
+
+// Number of alive cells of board b
+int alive(const std::vector<char>& b) {
+    int a = 0;
+    for (size_t i = 0; i < b.size(); i++)
+        a += b[i];
+    return a;
+}
+
+// Print board b like Life::print, with the border of 2 dead cells
+void printBoard(std::ostream& os, const std::vector<char>& b, int n) {
+    Sink::Timer timer;
+    if (Sink::compact()) {
+        for (int r = -2; r < n+2; r++)
+            for (int c = -2; c < n+2; c++)
+                os << cell(b, n, r, c);
+        os << '\n';
+        return;
+    }
+    os << "\t";
+    for (int r = -2; r < n+2; r++) {
+        for (int c = -2; c < n+2; c++)
+            os << cell(b, n, r, c) << "\t";
+        os << "\n\t";
+    }
+    os << "Number of Alive:" << alive(b) << '\n';
+    os << '\n';
+}
+
+#endif
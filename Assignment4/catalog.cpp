@@ -0,0 +1,120 @@
+/*
+ * Dense still lifes to seed the search with.
+ *
+ * A seed is the densest of the following boards that passes the
+ * still-life check:
+ *  - the grid of blocks (2 x 2 squares) with pitch 3, which fits any n
+ *    and is optimal for n = 8 (36 alive cells);
+ *  - every pattern of the catalog that fits, repeated with a gap of 2
+ *    dead cells. A dead cell in such a gap sees only one pattern, just
+ *    as outside a single pattern, so the repetition stays a still life.
+ * The catalog holds optimal boards for small n: the one for n = 9 is
+ * from the logged runs of life.cpp, the others were found offline by
+ * exhaustive search over consecutive pairs of rows.
+ */
+
+#ifndef ASSIGNMENT4_CATALOG
+#define ASSIGNMENT4_CATALOG
+
+#include <vector>
+#include "board.cpp"
+
+// A known still life of size n x n, row by row ('1' for alive)
+class Pattern {
+public:
+    int n;
+    const char* rows[16];
+};
+
+static const Pattern catalog[] = {
+    // optimal for n = 3 (6 alive cells)
+    { 3, {
+        "011",
+        "101",
+        "110" } },
+    // optimal for n = 4 (8 alive cells)
+    { 4, {
+        "0011",
+        "0101",
+        "1010",
+        "1100" } },
+    // optimal for n = 6 (18 alive cells)
+    { 6, {
+        "110110",
+        "110101",
+        "000101",
+        "111010",
+        "100100",
+        "011000" } },
+    // optimal for n = 7 (28 alive cells)
+    { 7, {
+        "1101101",
+        "0101011",
+        "1001000",
+        "1110111",
+        "0001001",
+        "1101010",
+        "1011011" } },
+    // optimal for n = 9 (43 alive cells), from the logged run
+    { 9, {
+        "110110110",
+        "101101101",
+        "000000001",
+        "011111010",
+        "100001011",
+        "111101001",
+        "000101100",
+        "110100101",
+        "110110011" } },
+    // optimal for n = 10 (54 alive cells)
+    { 10, {
+        "1101101101",
+        "1101101011",
+        "0000001000",
+        "1111110111",
+        "1000001001",
+        "0101101010",
+        "1101101011",
+        "1000001010",
+        "0101101010",
+        "1101011011" } }
+};
+
+// Blocks with pitch 3 on an n x n board
+std::vector<char> blocks(int n) {
+    std::vector<char> b(n*n, 0);
+    for (int r = 0; r+1 < n; r += 3)
+        for (int c = 0; c+1 < n; c += 3)
+            for (int i = 0; i < 2; i++)
+                for (int j = 0; j < 2; j++)
+                    b[(r+i)*n+c+j] = 1;
+    return b;
+}
+
+// Pattern p repeated on an n x n board with gaps of 2 dead cells
+std::vector<char> repeat(const Pattern& p, int n) {
+    std::vector<char> b(n*n, 0);
+    for (int r = 0; r+p.n <= n; r += p.n+2)
+        for (int c = 0; c+p.n <= n; c += p.n+2)
+            for (int i = 0; i < p.n; i++)
+                for (int j = 0; j < p.n; j++)
+                    b[(r+i)*n+c+j] = (p.rows[i][j] == '1');
+    return b;
+}
+
+// The densest still life of the catalog for an n x n board
+std::vector<char> seed(int n) {
+    std::vector<char> best = blocks(n);
+    if (!stillLife(best, n))
+        best.assign(n*n, 0);
+    for (size_t k = 0; k < sizeof(catalog)/sizeof(Pattern); k++) {
+        if (catalog[k].n > n)
+            continue;
+        std::vector<char> b = repeat(catalog[k], n);
+        if (stillLife(b, n) && (alive(b) > alive(best)))
+            best = b;
+    }
+    return best;
+}
+
+#endif
@@ -27,6 +27,8 @@
  */
 
 #include <gecode/int.hh>
+#include <gecode/int/branch.hh>
+#include "../common/profile.cpp"
 
 using namespace Gecode;
 
@@ -72,6 +74,14 @@ protected:
       // You must also archive the additional information
         e << pos << intrlvS << intrlvE;
     }
+    // Alternative 0 posts x <= lq(), alternative 1 posts x >= gq(). commit
+    // and ngl both use these, so a no-good is what its alternative posted.
+    int lq(void) const {
+      return intrlvE;
+    }
+    int gq(void) const {
+      return intrlvS+1;
+    }
   };
 public:
   // Construct branching
@@ -134,25 +144,37 @@ public:
 
     // FILL IN HERE
       int pos = d.pos;
-      int smallest = d.intrlvS;
-      int largest = d.intrlvE;
+      PROFILE_SCOPE(prof, "IntervalBrancher::commit");
+      PROFILE_MARK(prof, x[pos].size());
       
-      // when it is the first choice, we check if the largest value to force the obligatory part is inside x[pos].
-      // if it is not inside x[pos], this means that using x[pos].lq(home, largest), the output will have a larger obligatory part
-      // and we avoid that by returning failed, forcing the second choice
+      ModEvent me;
+      // The first choice forces the obligatory part. This must not fail when d.lq() is
+      // not in x[pos]: the second choice only removes the smallest value, so that value
+      // would never be tried.
       if (a == 0){
-          if (x[pos].in(largest)){
-              return me_failed(x[pos].lq(home, largest)) ? ES_FAILED : ES_OK;
-          } else {
-              return ES_FAILED;
-          }
+          me = x[pos].lq(home, d.lq());
       }
       // The second choice removes the smallest value of the store
       else {
-          return me_failed(x[pos].gq(home,smallest+1)) ? ES_FAILED : ES_OK;
+          me = x[pos].gq(home, d.gq());
       }
+      if (me_failed(me)) {
+          PROFILE_FAILED(prof);
+          return ES_FAILED;
+      }
+      PROFILE_PRUNED(prof, x[pos].size());
+      return ES_OK;
       
 
+  }
+  // Return no-good literal for alternative a (used by restarts with no-goods)
+  virtual NGL* ngl(Space& home, const Choice& c, unsigned int a) const {
+      const Description& d = static_cast<const Description&>(c);
+      // The literals are exactly what commit posts for each alternative
+      if (a == 0)
+          return new (home) Int::Branch::LqNGL<IntView>(home, x[d.pos], d.lq());
+      else
+          return new (home) Int::Branch::GqNGL<IntView>(home, x[d.pos], d.gq());
   }
   // Print some information on stream o (used by Gist, from Gecode 4.0.1 on)
   virtual void print(const Space& home, const Choice& c, unsigned int b,
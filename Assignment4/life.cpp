@@ -1,22 +1,94 @@
 #include <gecode/driver.hh>
 #include <gecode/int.hh>
 #include <gecode/minimodel.hh>
+#include <cmath>
+#include "../common/engine.cpp"
+#include "wavefront.cpp"
+#include "tiles.cpp"
+#include "catalog.cpp"
 
 using namespace Gecode;
 
-class Life : public Script {
+// The models
+enum {
+    MODEL_PLAIN,    // a sum over the 8 neighbours of every cell
+    MODEL_SHARED    // neighbourhoods from shared column sums
+};
+
+// The branchings
+enum {
+    BRANCH_SIZE,        // largest domain first, largest value first
+    BRANCH_WAVEFRONT    // row by row, most constrained cell of the row
+};
+
+class LifeOptions : public EngineOptions {
+protected:
+    // Size of the tiles for large boards (0 to solve the whole board)
+    Driver::UnsignedIntOption _tile;
+    // Milliseconds to improve one tile
+    Driver::UnsignedIntOption _tile_time;
+    // Whether to start from the densest still life of the catalog
+    Driver::BoolOption _catalog;
+public:
+    LifeOptions(const char* s)
+    : EngineOptions(s),
+      _tile("-tile", "solve large boards in tiles of this size (0 for off)", 0),
+      _tile_time("-tile-time", "milliseconds to improve one tile", 1000),
+      _catalog("-catalog", "start from the densest still life of the catalog",
+               true) {
+        add(_tile);
+        add(_tile_time);
+        add(_catalog);
+    }
+    unsigned int tile(void) const {
+        return _tile.value();
+    }
+    unsigned int tile_time(void) const {
+        return _tile_time.value();
+    }
+    bool catalog(void) const {
+        return _catalog.value();
+    }
+};
+
+// Alive cells of the seed, solutions must have more (0 without seed)
+int seeded = 0;
+
+class Life : public Script, public Objective {
 public:
 
     BoolVarArray q;
     
     /// The actual problem
     Life(const SizeOptions& opt)
-    : Script(opt), q(*this,(opt.size()+4)*(opt.size()+4),0,1) {
+    : Script(opt), q(*this,(opt.size()+4)*(opt.size()+4)) {
         
         // the plus 4 is to add the border with 2 cells thickness
         int n = opt.size()+4;
         Matrix<BoolVarArgs> board(q, n, n);
 
+        if (opt.model() == MODEL_SHARED) {
+            shared(n, board);
+        } else {
+            for (int i = 0; i < q.size(); i++)
+                q[i] = BoolVar(*this, 0, 1);
+            plain(n, board);
+        }
+
+        // the seed is the first bound of BAB
+        if (seeded > 0)
+            linear(*this, q, IRT_GR, seeded);
+
+        //branching
+        if (opt.branching() == BRANCH_WAVEFRONT)
+            wavefront(*this, q, n);
+        else
+            branch(*this, q, INT_VAR_SIZE_MAX(), INT_VAL_MAX());
+        
+    }
+
+    // Every cell sums its 8 neighbours
+    void plain(int n, Matrix<BoolVarArgs>& board) {
         // set the value on the border to 0
         for (int i = 0; i<2; i++){
             linear(*this, board.row(i), IRT_EQ, 0);
@@ -51,17 +123,95 @@ public:
             }
             
         }
+    }
 
-        //branching
-         branch(*this, q, INT_VAR_SIZE_MAX(), INT_VAL_MAX());
-        
+    /*
+     * Every vertical triple of cells is summed once, and the 3x3 block
+     * around a cell is the sum of three such column sums. The block
+     * counts the cell itself, so a live cell needs 3 or 4 and a dead
+     * cell anything but 3. The border is one shared constant.
+     */
+    void shared(int n, Matrix<BoolVarArgs>& board) {
+        BoolVar dead(*this, 0, 0);
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < n; j++)
+                q[i*n+j] = ((i < 2) || (j < 2) || (i >= n-2) || (j >= n-2)) ?
+                    dead : BoolVar(*this, 0, 1);
+        IntVar zero(*this, 0, 0);
+
+        // column sums centred on rows 1..n-2, constant on the border
+        IntVarArray column(*this, n*n);
+        for (int i = 1; i < n-1; i++) {
+            for (int j = 0; j < n; j++) {
+                if ((j < 2) || (j >= n-2)) {
+                    column[i*n+j] = zero;
+                } else {
+                    column[i*n+j] = IntVar(*this, 0, 3);
+                    BoolVarArgs triple(3);
+                    for (int m = 0; m < 3; m++)
+                        triple[m] = board(i-1+m,j);
+                    linear(*this, triple, IRT_EQ, column[i*n+j]);
+                }
+            }
+        }
+
+        // we start on the inner row of the border.
+        // the outer will never change since the inner doesn't change
+        for (int i = 1; i < n-1; i++) {
+            for (int j = 1; j < n-1; j++) {
+                IntVarArgs columns(3);
+                for (int l = 0; l < 3; l++)
+                    columns[l] = column[i*n+j-1+l];
+                IntVar block(*this, 0, 9);
+                linear(*this, columns, IRT_EQ, block);
+                if ((i < 2) || (j < 2) || (i >= n-2) || (j >= n-2)) {
+                    // a border cell stays dead
+                    rel(*this, block, IRT_NQ, 3);
+                } else {
+                    // if the cell is alive it must have 2 or 3 alive neighbours
+                    dom(*this, block, 3, 4, Reify(board(i,j), RM_IMP));
+                    // if the cell is dead it cannot have 3 neighbours
+                    rel(*this, block, IRT_EQ, 3, Reify(board(i,j), RM_PMI));
+                }
+            }
+        }
     }
+
     // constraint for finding better solutions
     virtual void constrain(const Space& _b) {
         const Life& b = static_cast<const Life&>(_b);
         rel(*this, sum(q) > sum(b.q));
     }
     
+    // number of alive cells in a solution
+    virtual int objective(void) const {
+        int alive = 0;
+        for (int i = 0; i < q.size(); i++)
+            alive += q[i].val();
+        return alive;
+    }
+
+    // at most 6 of the 9 cells of a 3 x 3 block are alive in a still life
+    virtual int bound(void) const {
+        int n = static_cast<int>(std::sqrt(static_cast<double>(q.size())));
+        int most = 0;
+        for (int r = 0; r < n; r += 3)
+            for (int c = 0; c < n; c += 3) {
+                int free = 0;
+                for (int i = r; i < std::min(r+3, n); i++)
+                    for (int j = c; j < std::min(c+3, n); j++)
+                        free += q[i*n+j].max();
+                most += std::min(free, 6);
+            }
+        return most;
+    }
+
+    // the seed is a solution known before the search
+    virtual bool known(int& v) const {
+        v = seeded;
+        return seeded > 0;
+    }
+    
     /// Constructor for cloning
     Life(bool share, Life& s) : Script(share,s) {
         q.update(*this, share, s.q);
@@ -76,25 +226,38 @@ public:
     /// Print solution
     virtual void
     print(std::ostream& os) const {
+        Sink::Timer timer;
+        if (Sink::compact()) {
+            Sink::line(os, q, 0);
+            return;
+        }
         int size = sqrt(q.size()+4);
         int alive = 0;
         
-        std::cout << "\t";
+        os << "\t";
         for (int i = 0; i < q.size(); i++) {
             if (q[i].val()==1){
                 alive++;
             }
-            std::cout << q[i] << "\t";
+            os << q[i] << "\t";
             if ((i+1) % size == 0)
-                std::cout << std::endl << "\t";
+                os << "\n\t";
         }
-        std::cout << "Number of Alive:" << alive << std::endl;
-        std::cout << std::endl;
+        os << "Number of Alive:" << alive << '\n';
+        os << '\n';
     }
 };
 
 int main(int argc, char* argv[]) {
-    SizeOptions opt("Life");
+    LifeOptions opt("Life");
+    opt.model(MODEL_SHARED);
+    opt.model(MODEL_PLAIN, "plain", "sum the 8 neighbours of every cell");
+    opt.model(MODEL_SHARED, "shared",
+              "share column sums, constant border");
+    opt.branching(BRANCH_WAVEFRONT);
+    opt.branching(BRANCH_SIZE, "size", "largest domain, largest value");
+    opt.branching(BRANCH_WAVEFRONT, "wavefront",
+                  "row by row, most constrained cell first");
     int in;
     std::cout << "Please enter the number of size of board" << std::endl;
     std::cin >> in;
@@ -107,7 +270,37 @@ int main(int argc, char* argv[]) {
     opt.size(in);
     opt.solutions(0);
     opt.parse(argc,argv);
-    Script::run<Life,BAB,SizeOptions>(opt);
+    Sink::install(std::cout, opt.sink());
+    std::vector<char> start(opt.size()*opt.size(), 0);
+    if (opt.catalog()) {
+        start = seed(opt.size());
+        seeded = alive(start);
+        std::cout << "Seed from catalog" << '\n';
+        printBoard(std::cout, start, opt.size());
+    }
+    if (opt.tile() > 0) {
+        // tiles closer than 3 cells would read each other's changes
+        int t = std::max(3, static_cast<int>(opt.tile()));
+        unsigned int threads = (opt.threads() >= 1.0) ?
+            static_cast<unsigned int>(opt.threads()) :
+            std::max(1u, std::thread::hardware_concurrency());
+        Sink::Clock::time_point started = Sink::Clock::now();
+        int rounds;
+        std::vector<char> b = tiled(start, opt.size(), t, threads,
+                                    opt.tile_time(), rounds);
+        double ms = std::chrono::duration_cast<std::chrono::microseconds>
+            (Sink::Clock::now() - started).count() / 1000.0;
+        std::cout << opt.name() << " (tiles of size " << t << ")" << '\n';
+        printBoard(std::cout, b, opt.size());
+        std::cout << "Summary" << '\n'
+                  << "\truntime:      " << ms << " ms" << '\n'
+                  << "\trounds:       " << rounds << '\n'
+                  << "\tthreads:      " << threads << '\n'
+                  << "\tstill life:   " << (stillLife(b, opt.size()) ? "yes" : "no")
+                  << '\n';
+        return 0;
+    }
+    solve<Life,BAB>(opt);
     return 0;
     
 }
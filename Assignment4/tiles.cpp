@@ -0,0 +1,188 @@
+/*
+ * Tiled solving of large Life boards.
+ *
+ * The board is improved one tile at a time. A tile is a rectangle of
+ * the board whose cells are free, surrounded by a ring of 2 cells fixed
+ * to the current board. The rules are enforced on the tile and on the
+ * inner ring, whose neighbourhoods reach into the tile; the outer ring
+ * only provides neighbours, and its own rules cannot change as no
+ * neighbour of it is free. So a tile solution that replaces the tile
+ * keeps the whole board a still life, and it is only accepted if it has
+ * more alive cells than the tile had.
+ *
+ * Tiles of size t form a grid that is coloured by the parity of their
+ * row and column in it. Tiles of one colour are at least t >= 3 cells
+ * apart, further than the 2 cells a tile reads around it, so they are
+ * solved in parallel, one thread each. Every round shifts the grid by
+ * t/2 in both directions, so the seams of one round are inside the
+ * tiles of the next. Rounds stop when two in a row improve nothing.
+ */
+
+#ifndef ASSIGNMENT4_TILES
+#define ASSIGNMENT4_TILES
+
+#include <gecode/int.hh>
+#include <gecode/search.hh>
+#include <gecode/minimodel.hh>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include "wavefront.cpp"
+#include "board.cpp"
+
+using namespace Gecode;
+
+class LifeTile : public Space {
+public:
+    // Free cells of the tile row by row
+    BoolVarArray x;
+
+    // Tile at row r0 and column c0 of height h and width w of board b
+    LifeTile(const std::vector<char>& b, int n, int r0, int c0, int h, int w)
+    : x(*this, h*w, 0, 1) {
+        // the tile with its ring of 2 cells
+        int W = w+4;
+        BoolVarArgs q((h+4)*W);
+        BoolVar dead(*this, 0, 0), live(*this, 1, 1);
+        for (int i = 0; i < h+4; i++)
+            for (int j = 0; j < W; j++) {
+                if ((i >= 2) && (j >= 2) && (i < h+2) && (j < w+2))
+                    q[i*W+j] = x[(i-2)*w+j-2];
+                else
+                    q[i*W+j] = cell(b, n, r0+i-2, c0+j-2) ? live : dead;
+            }
+
+        // the rules on the tile and the inner ring
+        for (int i = 1; i < h+3; i++) {
+            for (int j = 1; j < W-1; j++) {
+                BoolVarArgs block(9);
+                for (int m = 0; m < 3; m++)
+                    for (int l = 0; l < 3; l++)
+                        block[m*3+l] = q[(i-1+m)*W+j-1+l];
+                IntVar s(*this, 0, 9);
+                linear(*this, block, IRT_EQ, s);
+                // the block counts the cell itself
+                dom(*this, s, 3, 4, Reify(q[i*W+j], RM_IMP));
+                rel(*this, s, IRT_EQ, 3, Reify(q[i*W+j], RM_PMI));
+            }
+        }
+
+        // only better tiles are of interest
+        int before = 0;
+        for (int i = 0; i < h; i++)
+            for (int j = 0; j < w; j++)
+                before += cell(b, n, r0+i, c0+j);
+        linear(*this, x, IRT_GR, before);
+
+        wavefront(*this, x, w);
+    }
+
+    // Number of alive cells
+    int alive(void) const {
+        int a = 0;
+        for (int i = 0; i < x.size(); i++)
+            a += x[i].val();
+        return a;
+    }
+
+    // constraint for finding better solutions
+    virtual void constrain(const Space& _b) {
+        const LifeTile& b = static_cast<const LifeTile&>(_b);
+        linear(*this, x, IRT_GR, b.alive());
+    }
+
+    /// Constructor for cloning
+    LifeTile(bool share, LifeTile& s) : Space(share,s) {
+        x.update(*this, share, s.x);
+    }
+
+    /// Perform copying during cloning
+    virtual Space*
+    copy(bool share) {
+        return new LifeTile(share,*this);
+    }
+};
+
+// A tile of the board
+class Tile {
+public:
+    int r, c, h, w;
+};
+
+/*
+ * Improve the tile t of board b for at most ms milliseconds. Returns
+ * whether the tile got better, in which case it is written to b.
+ */
+bool improve(std::vector<char>& b, int n, const Tile& t, unsigned int ms) {
+    Search::TimeStop stop(ms);
+    Search::Options so;
+    so.threads = 1;
+    so.stop = &stop;
+    BAB<LifeTile> e(new LifeTile(b, n, t.r, t.c, t.h, t.w), so);
+    LifeTile* best = NULL;
+    while (LifeTile* s = e.next()) {
+        delete best;
+        best = s;
+    }
+    if (best == NULL)
+        return false;
+    for (int i = 0; i < t.h; i++)
+        for (int j = 0; j < t.w; j++)
+            b[(t.r+i)*n+t.c+j] = best->x[i*t.w+j].val();
+    delete best;
+    return true;
+}
+
+/*
+ * Tiles of size t for round k, grouped by colour. The grid is shifted by
+ * t/2 in odd rounds and clipped to the board.
+ */
+std::vector<std::vector<Tile> > tiles(int n, int t, int k) {
+    std::vector<std::vector<Tile> > colours(4);
+    int o = (k % 2 == 0) ? 0 : -(t/2);
+    for (int r = o, ti = 0; r < n; r += t, ti++)
+        for (int c = o, tj = 0; c < n; c += t, tj++) {
+            Tile tile;
+            tile.r = std::max(r, 0); tile.c = std::max(c, 0);
+            tile.h = std::min(r+t, n) - tile.r;
+            tile.w = std::min(c+t, n) - tile.c;
+            if ((tile.h > 0) && (tile.w > 0))
+                colours[(ti % 2)*2 + tj % 2].push_back(tile);
+        }
+    return colours;
+}
+
+/*
+ * Improve the still life b on an n x n board with tiles of size t, using
+ * the given number of threads and at most ms milliseconds per tile.
+ * Returns the board; rounds is set to the number of rounds run.
+ */
+std::vector<char> tiled(std::vector<char> b, int n, int t,
+                        unsigned int threads, unsigned int ms, int& rounds) {
+    int idle = 0;
+    for (rounds = 0; idle < 2; rounds++) {
+        bool better = false;
+        std::vector<std::vector<Tile> > colours = tiles(n, t, rounds);
+        for (size_t k = 0; k < colours.size(); k++) {
+            const std::vector<Tile>& ts = colours[k];
+            std::atomic<size_t> next(0);
+            std::atomic<bool> improved(false);
+            std::vector<std::thread> workers;
+            for (unsigned int i = 0; i < std::min<size_t>(threads, ts.size());
+                 i++)
+                workers.push_back(std::thread([&]() {
+                    for (size_t j = next++; j < ts.size(); j = next++)
+                        if (improve(b, n, ts[j], ms))
+                            improved = true;
+                }));
+            for (size_t i = 0; i < workers.size(); i++)
+                workers[i].join();
+            better = better || improved;
+        }
+        idle = better ? 0 : idle+1;
+    }
+    return b;
+}
+
+#endif
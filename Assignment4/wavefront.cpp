@@ -0,0 +1,133 @@
+/*
+ * Wavefront branching for still lifes.
+ *
+ * The board is filled row by row: the front is the first row that still
+ * has unassigned cells. Within the front the brancher picks the cell
+ * with most assigned neighbours, so each decision is checked against as
+ * much of the finished board as possible, and tries it alive first.
+ * With the border fixed, a bad choice fails within a row or two instead
+ * of surfacing deep in the tree.
+ */
+
+#ifndef ASSIGNMENT4_WAVEFRONT
+#define ASSIGNMENT4_WAVEFRONT
+
+#include <gecode/int.hh>
+#include <algorithm>
+#include "../common/profile.cpp"
+
+using namespace Gecode;
+using namespace Gecode::Int;
+
+class WavefrontBrancher : public Brancher {
+protected:
+    // Cells of the board row by row
+    ViewArray<BoolView> x;
+    // Width of the board
+    int w;
+    // Cache of the first unassigned cell
+    mutable int start;
+    // Description
+    class Description : public Choice {
+    public:
+        // Position of the cell
+        int pos;
+        Description(const Brancher& b, unsigned int a, int p)
+        : Choice(b,a), pos(p) {}
+        // Report size occupied
+        virtual size_t size(void) const {
+            return sizeof(Description);
+        }
+        // Archive the choice's information in e
+        virtual void archive(Archive& e) const {
+            Choice::archive(e);
+            e << pos;
+        }
+    };
+
+    // Number of assigned neighbours of cell p
+    int assigned(int p) const {
+        int r = p / w, c = p % w, h = x.size() / w, a = 0;
+        for (int i = std::max(r-1, 0); i <= std::min(r+1, h-1); i++)
+            for (int j = std::max(c-1, 0); j <= std::min(c+1, w-1); j++)
+                if (((i != r) || (j != c)) && x[i*w+j].assigned())
+                    a++;
+        return a;
+    }
+public:
+    // Construct branching
+    WavefrontBrancher(Home home, ViewArray<BoolView>& x0, int w0)
+    : Brancher(home), x(x0), w(w0), start(0) {}
+    // Post branching
+    static void post(Home home, ViewArray<BoolView>& x, int w) {
+        (void) new (home) WavefrontBrancher(home,x,w);
+    }
+
+    // Copy constructor used during cloning of b
+    WavefrontBrancher(Space& home, bool share, WavefrontBrancher& b)
+    : Brancher(home, share, b), w(b.w), start(b.start) {
+        x.update(home,share,b.x);
+    }
+    // Copy brancher
+    virtual Actor* copy(Space& home, bool share) {
+        return new (home) WavefrontBrancher(home, share, *this);
+    }
+
+    // Check status of brancher, return true if alternatives left
+    virtual bool status(const Space&) const {
+        for (int i=start; i<x.size(); i++)
+            if (!x[i].assigned()) {
+                start = i;
+                return true;
+            }
+        return false;
+    }
+    // Return choice as description
+    virtual Choice* choice(Space&) {
+        PROFILE_SCOPE(prof, "WavefrontBrancher::choice");
+        // The front is the row of the first unassigned cell
+        int end = std::min((start / w + 1) * w, x.size());
+        int best = start, most = -1;
+        for (int i = start; i < end; i++)
+            if (!x[i].assigned()) {
+                int a = assigned(i);
+                if (a > most) {
+                    best = i; most = a;
+                }
+            }
+        return new Description(*this, 2, best);
+    }
+    // Construct choice from archive e
+    virtual const Choice* choice(const Space&, Archive& e) {
+        int pos;
+        e >> pos;
+        return new Description(*this, 2, pos);
+    }
+    // Perform commit for choice c and alternative a
+    virtual ExecStatus commit(Space& home, const Choice& c, unsigned int a) {
+        const Description& d = static_cast<const Description&>(c);
+        // Alive first, as Life maximises the number of alive cells
+        return me_failed(x[d.pos].eq(home, (a == 0) ? 1 : 0)) ?
+            ES_FAILED : ES_OK;
+    }
+    // Print some information on stream o
+    virtual void print(const Space&, const Choice& c, unsigned int a,
+                       std::ostream& o) const {
+        const Description& d = static_cast<const Description&>(c);
+        o << "x[" << d.pos / w << "," << d.pos % w << "] = "
+          << ((a == 0) ? 1 : 0);
+    }
+};
+
+// Branch on the cells x of a board of width w along a wavefront
+void wavefront(Home home, const BoolVarArgs& x, int w) {
+    // Check whether arguments make sense
+    if ((w <= 0) || (x.size() % w != 0))
+        throw ArgumentSizeMismatch("wavefront");
+    // Never post a branching in a failed space
+    if (home.failed()) return;
+    ViewArray<BoolView> vx(home,x);
+    WavefrontBrancher::post(home,vx,w);
+}
+
+#endif
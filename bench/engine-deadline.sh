@@ -0,0 +1,38 @@
+#!/bin/sh
+#
+# Check that a run cut off by -deadline reports incumbent, bound and gap.
+#
+# Usage: engine-deadline.sh <life binary> <square binary>... [-- deadline ms]
+#
+# Life is run on a board and each square model on an n that none of them
+# finishes within the deadline, so the engine has to compute the bound
+# over the open part of the tree. A run fails the check if it does not
+# reach the gap report, for instance because it aborted on the way.
+
+deadline=2000
+bins=
+while [ $# -gt 0 ]; do
+    case "$1" in
+        --) deadline=${2:?missing deadline}; shift 2 ;;
+        *) bins="$bins $1"; shift ;;
+    esac
+done
+[ -n "$bins" ] || { echo "usage: $0 <life binary> <square binary>... [-- deadline ms]"; exit 2; }
+
+status=0
+for bin in $bins; do
+    case "$bin" in
+        *life*) size=24 ;;
+        *) size=40 ;;
+    esac
+    printf "%-40s %4s " "$bin" "$size"
+    out=$(echo "$size" | "$bin" -deadline "$deadline" 2>&1)
+    if echo "$out" | grep -q "bound:"; then
+        echo "$out" | awk '/incumbent:/ { i=$2 } /bound:/ { b=$2 } /gap:/ { g=$2 }
+            END { printf "incumbent %s bound %s gap %s\n", i, b, g }'
+    else
+        echo "no gap report"
+        status=1
+    fi
+done
+exit $status
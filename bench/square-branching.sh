@@ -0,0 +1,32 @@
+#!/bin/sh
+#
+# Compare branching on all x, then all y against bottom-left placement.
+#
+# Usage: square-branching.sh <square binary> [first n] [last n] [time limit ms]
+#
+# The binary is any of the compiled square models; square-noOverlapCheck
+# is the one the bottom-left brancher is meant for. Each n is solved for
+# the optimal s with -branching xy and -branching bottomleft; runs are
+# cut off after the time limit.
+
+bin=${1:?usage: $0 <square binary> [first n] [last n] [time limit ms]}
+first=${2:-10}
+last=${3:-25}
+limit=${4:-600000}
+
+summary() {
+    awk '/runtime:/ { t=$3 } /nodes:/ { nd=$2 } /failures:/ { f=$2 }
+         /peak depth:/ { d=$3 } /Smallest S/ { s=$4 }
+         END { printf "%-8s %12s %12s %6s %10s\n", s, nd, f, d, t }'
+}
+
+printf "%-4s %-11s %-8s %12s %12s %6s %10s\n" \
+    n branching s nodes failures depth runtime
+n=$first
+while [ "$n" -le "$last" ]; do
+    for b in xy bottomleft; do
+        printf "%-4s %-11s " "$n" "$b"
+        echo "$n" | "$bin" -time "$limit" -branching "$b" | summary
+    done
+    n=$((n+1))
+done
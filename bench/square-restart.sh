@@ -0,0 +1,31 @@
+#!/bin/sh
+#
+# Compare plain DFS against restarts with no-goods on the square models.
+#
+# Usage: square-restart.sh <square binary> [first n] [last n] [time limit ms]
+#
+# The binary is any of the compiled square models (square, square-noOverlapCheck
+# or square-IntervalCheck). Each n is run once with DFS and once with Luby
+# restarts recording no-goods; runs are cut off after the time limit.
+
+bin=${1:?usage: $0 <square binary> [first n] [last n] [time limit ms]}
+first=${2:-15}
+last=${3:-25}
+limit=${4:-600000}
+
+summary() {
+    awk '/runtime:/ { t=$3 } /nodes:/ { nd=$2 } /failures:/ { f=$2 }
+         /restarts:/ { r=$2 } /no-goods:/ { ng=$2 } /Smallest S/ { s=$4 }
+         END { printf "%-8s %12s %12s %8s %8s %10s\n", s, nd, f, r, ng, t }'
+}
+
+printf "%-4s %-10s %-8s %12s %12s %8s %8s %10s\n" \
+    n search s nodes failures restarts no-goods runtime
+n=$first
+while [ "$n" -le "$last" ]; do
+    printf "%-4s %-10s " "$n" dfs
+    echo "$n" | "$bin" -time "$limit" | summary
+    printf "%-4s %-10s " "$n" luby
+    echo "$n" | "$bin" -time "$limit" -restart luby -nogoods true | summary
+    n=$((n+1))
+done
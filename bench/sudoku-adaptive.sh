@@ -0,0 +1,39 @@
+#!/bin/sh
+#
+# Compare fixed and adaptive propagation strength of distinct on the
+# Sudoku examples.
+#
+# Usage: sudoku-adaptive.sh <sudoku binary> [failure threshold] [time limit ms]
+#
+# Every example 0-17 is solved for its first solution with value and
+# domain consistent distinct throughout, and with -adaptive, which starts
+# with value consistency and strengthens the units with most failures on
+# every restart (Luby cutoffs scaled by the threshold). The presolve is
+# disabled so all deduction is left to propagation.
+
+bin=${1:?usage: $0 <sudoku binary> [failure threshold] [time limit ms]}
+fails=${2:-50}
+limit=${3:-600000}
+
+summary() {
+    awk '/runtime:/ { t=$3 } /propagations:/ { p=$2 } /nodes:/ { nd=$2 }
+         /failures:/ { f=$2 } /restarts:/ { r=$2 }
+         END { printf "%10s %10s %8s %14s %10s\n", nd, f, r, p, t }'
+}
+
+printf "%-8s %-9s %10s %10s %8s %14s %10s\n" \
+    example mode nodes failures restarts propagations runtime
+e=0
+while [ "$e" -le 17 ]; do
+    for mode in val dom adaptive; do
+        printf "%-8s %-9s " "$e" "$mode"
+        if [ "$mode" = adaptive ]; then
+            set -- -adaptive true -adaptive-fails "$fails"
+        else
+            set -- -icl "$mode"
+        fi
+        echo "$e" | "$bin" -presolve false -solutions 1 -time "$limit" "$@" |
+            summary
+    done
+    e=$((e+1))
+done
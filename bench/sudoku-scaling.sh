@@ -0,0 +1,52 @@
+#!/bin/sh
+#
+# Compare the propagation strengths of distinct on Sudoku of growing order.
+#
+# Usage: sudoku-scaling.sh <sudoku binary> [orders] [blank ratio] [seed] [time limit ms]
+#
+# For every order k a puzzle of size k^2 x k^2 is generated: a valid grid
+# with relabelled digits from which the given ratio of cells is blanked.
+# The puzzle is solved for its first solution with -icl val, bnd and dom.
+# The presolve is disabled so all deduction is left to propagation.
+
+bin=${1:?usage: $0 <sudoku binary> [orders] [blank ratio] [seed] [time limit ms]}
+orders=${2:-"3 4 5 6"}
+blank=${3:-0.6}
+seed=${4:-1}
+limit=${5:-600000}
+puzzle=${TMPDIR:-/tmp}/sudoku-scaling.$$
+trap 'rm -f "$puzzle"' EXIT
+
+# Print a puzzle of order k in the format read by -file
+generate() {
+    awk -v k="$1" -v blank="$blank" -v seed="$seed" 'BEGIN {
+        srand(seed); n = k*k
+        for (i = 1; i <= n; i++) p[i] = i
+        for (i = n; i > 1; i--) { j = int(rand()*i) + 1; t = p[i]; p[i] = p[j]; p[j] = t }
+        print k
+        for (r = 0; r < n; r++) {
+            line = ""
+            for (c = 0; c < n; c++) {
+                v = p[((r % k)*k + int(r/k) + c) % n + 1]
+                line = line (rand() < blank ? "." : v) " "
+            }
+            print line
+        }
+    }'
+}
+
+summary() {
+    awk '/runtime:/ { t=$3 } /propagations:/ { p=$2 } /nodes:/ { nd=$2 }
+         /failures:/ { f=$2 }
+         END { printf "%12s %12s %14s %10s\n", nd, f, p, t }'
+}
+
+printf "%-6s %-4s %12s %12s %14s %10s\n" \
+    order icl nodes failures propagations runtime
+for k in $orders; do
+    generate "$k" > "$puzzle"
+    for icl in val bnd dom; do
+        printf "%-6s %-4s " "$k" "$icl"
+        "$bin" -file "$puzzle" -presolve false -icl "$icl" -solutions 1 -time "$limit" | summary
+    done
+done
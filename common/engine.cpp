@@ -0,0 +1,732 @@
+/*
+ * A small search engine for long runs.
+ *
+ * It explores the tree depth-first like DFS and BAB: it keeps the path
+ * of choices from the root and a clone every c_d levels, and recomputes
+ * the other nodes from the nearest clone. Unlike the engines used by
+ * Script::run it can tell at any time how deep it is and how many
+ * alternatives are still open, which is what the progress lines report.
+ *
+ * The open part of the tree is fully described by the path: every edge
+ * holds a choice and the alternative being explored, and all larger
+ * alternatives are still open. A checkpoint stores the path, with each
+ * choice archived by Choice::archive, together with the path to the
+ * incumbent solution. Resuming replays both paths from a fresh root.
+ *
+ * With a memory budget the explorer measures how large a clone is and
+ * spreads the clones on the path further apart (dropping the ones in
+ * between) whenever the clones would exceed the budget, and closer
+ * again when there is room. Deeper recomputation costs time, running
+ * out of memory costs the run.
+ *
+ * With a deadline the explorer stops once the time is up and reports
+ * the incumbent together with the bound that is proven for the rest of
+ * the tree: every open alternative is committed on a recomputed node
+ * and the best bound over those that do not fail is the best the
+ * unexplored tree could still reach. The gap is what is left to gain.
+ *
+ * Scripts call solve<Script,Engine>(opt) instead of Script::run. Without
+ * any of the engine options the call is forwarded to Script::run. Scripts
+ * that need the optimal solution afterwards call solveOptimal, which
+ * always explores and returns it once nothing open can beat it.
+ */
+
+#ifndef COMMON_ENGINE
+#define COMMON_ENGINE
+
+#include <gecode/driver.hh>
+#include <gecode/search.hh>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+#include "sink.cpp"
+
+using namespace Gecode;
+
+// Implemented by scripts that optimise, to report their objective
+class Objective {
+public:
+    virtual ~Objective(void) {}
+    // Value of the objective in a solution
+    virtual int objective(void) const = 0;
+    // Best value any solution of this space can still reach
+    virtual int bound(void) const = 0;
+    // Whether smaller values are better
+    virtual bool minimise(void) const {
+        return false;
+    }
+    // Value of a solution known before the search (such as a seed), if any
+    virtual bool known(int&) const {
+        return false;
+    }
+};
+
+// Size options plus the options of the engine
+class EngineOptions : public SizeOptions {
+protected:
+    // File for progress lines ("stderr" for standard error)
+    Driver::StringValueOption _progress;
+    // Milliseconds between progress lines
+    Driver::UnsignedIntOption _progress_interval;
+    // File to write checkpoints to
+    Driver::StringValueOption _checkpoint;
+    // Milliseconds between checkpoints
+    Driver::UnsignedIntOption _checkpoint_interval;
+    // Checkpoint file to resume from
+    Driver::StringValueOption _resume;
+    // How to write solutions
+    SinkOption _sink;
+    // Megabytes the clones of the explorer may take (0 for no limit)
+    Driver::UnsignedIntOption _memory_budget;
+    // Milliseconds until search stops with the incumbent (0 for none)
+    Driver::UnsignedIntOption _deadline;
+public:
+    EngineOptions(const char* s)
+    : SizeOptions(s),
+      _progress("-progress",
+                "write progress as JSON lines to file (or stderr)"),
+      _progress_interval("-progress-interval",
+                         "milliseconds between progress lines", 1000),
+      _checkpoint("-checkpoint", "write checkpoints to file"),
+      _checkpoint_interval("-checkpoint-interval",
+                           "milliseconds between checkpoints", 60000),
+      _resume("-resume", "resume search from checkpoint file"),
+      _memory_budget("-memory-budget",
+                     "megabytes the clones may take (0 for no limit)", 0),
+      _deadline("-deadline",
+                "milliseconds until search stops with the incumbent "
+                "(0 for none)", 0) {
+        add(_progress);
+        add(_progress_interval);
+        add(_checkpoint);
+        add(_checkpoint_interval);
+        add(_resume);
+        add(_sink);
+        add(_memory_budget);
+        add(_deadline);
+    }
+    const char* progress(void) const {
+        return _progress.value();
+    }
+    unsigned int progress_interval(void) const {
+        return _progress_interval.value();
+    }
+    const char* checkpoint(void) const {
+        return _checkpoint.value();
+    }
+    unsigned int checkpoint_interval(void) const {
+        return _checkpoint_interval.value();
+    }
+    const char* resume(void) const {
+        return _resume.value();
+    }
+    int sink(void) const {
+        return _sink.value();
+    }
+    unsigned int memory_budget(void) const {
+        return _memory_budget.value();
+    }
+    unsigned int deadline(void) const {
+        return _deadline.value();
+    }
+    // Whether the run needs the engine rather than Script::run
+    bool explore(void) const {
+        return (progress() != NULL) || (checkpoint() != NULL) ||
+            (resume() != NULL) || (memory_budget() > 0) || (deadline() > 0);
+    }
+};
+
+template<class S>
+class Explorer {
+protected:
+    typedef std::chrono::steady_clock Clock;
+
+    // Choice on the path and the alternative currently explored
+    class Edge {
+    public:
+        // Clone of the node before the choice (NULL if recomputed)
+        Space* s;
+        // The choice
+        const Choice* c;
+        // Alternative currently explored
+        unsigned int alt;
+        // Number of solutions found when s was cloned
+        unsigned long int gen;
+    };
+
+    const EngineOptions& opt;
+    // Whether every solution must be better than the previous one
+    bool bab;
+    // Path from the root to the current node
+    std::vector<Edge> path;
+    // Current node (NULL if it has to be recomputed)
+    Space* cur;
+    // Last solution found
+    S* best;
+    // Solution with the best objective found, and its objective
+    S* top;
+    int top_value;
+    // Archived path to the last solution found
+    std::vector<unsigned int> incumbent;
+
+    // Statistics
+    unsigned long int solutions;
+    unsigned long int nodes;
+    unsigned long int failures;
+    unsigned long int propagations;
+    unsigned long int peak;
+    // Failures per depth
+    std::vector<unsigned long int> fails;
+
+    // Memory
+    // Current copy distance
+    unsigned int cd;
+    // Largest copy distance used
+    unsigned int peak_cd;
+    // Largest clone seen in bytes
+    size_t clone_bytes;
+    // Number of clones on the path
+    unsigned long int clones;
+    // Largest estimated memory of the clones in bytes
+    size_t peak_memory;
+
+    // Whether the deadline stopped the search
+    bool expired;
+    // Whether the script has an objective and whether smaller is better
+    bool optimising;
+    bool minimising;
+    // Whether a solution was known before the search, and its value
+    bool known;
+    int known_value;
+
+    // Progress reporting
+    std::ostream* progress;
+    Clock::time_point started;
+    Clock::time_point reported;
+    // Time of the last checkpoint
+    Clock::time_point saved;
+
+    // Milliseconds since t
+    static double ms(Clock::time_point t) {
+        return std::chrono::duration_cast<std::chrono::microseconds>
+            (Clock::now() - t).count() / 1000.0;
+    }
+
+    // Number of alternatives not yet explored
+    unsigned long int open(void) const {
+        unsigned long int o = 0;
+        for (size_t i = 0; i < path.size(); i++)
+            o += path[i].c->alternatives() - path[i].alt - 1;
+        return o;
+    }
+
+    // Write one progress line
+    void report(void) {
+        double t = ms(started);
+        *progress << "{\"time\":" << std::fixed << std::setprecision(3) << t
+                  << ",\"nodes\":" << nodes
+                  << ",\"failures\":" << failures
+                  << ",\"depth\":" << path.size()
+                  << ",\"peak_depth\":" << peak
+                  << ",\"nodes_per_sec\":" << std::setprecision(1)
+                  << (t > 0 ? nodes * 1000.0 / t : 0.0)
+                  << ",\"open\":" << open()
+                  << ",\"clone_bytes\":" << clone_bytes
+                  << ",\"c_d\":" << cd
+                  << ",\"solutions\":" << solutions
+                  << ",\"best\":";
+        const Objective* o = dynamic_cast<const Objective*>(best);
+        if (o != NULL)
+            *progress << o->objective();
+        else
+            *progress << "null";
+        *progress << ",\"fail_hist\":[";
+        for (size_t d = 0; d < fails.size(); d++)
+            *progress << (d > 0 ? "," : "") << fails[d];
+        *progress << "]}" << std::endl;
+        reported = Clock::now();
+    }
+
+    // Archive the path from the root to the current node
+    std::vector<unsigned int> archive(void) const {
+        std::vector<unsigned int> v;
+        v.push_back(path.size());
+        for (size_t i = 0; i < path.size(); i++) {
+            Archive a;
+            path[i].c->archive(a);
+            v.push_back(path[i].alt);
+            v.push_back(a.size());
+            for (int j = 0; j < a.size(); j++)
+                v.push_back(a[j]);
+        }
+        return v;
+    }
+
+    /*
+     * Replay the archived path in v starting at position p on s. If keep
+     * is true the replayed edges become the path of the explorer.
+     */
+    Space* replay(Space* s, const std::vector<unsigned int>& v, size_t& p,
+                  bool keep) {
+        unsigned int m = v[p++];
+        for (unsigned int k = 0; k < m; k++) {
+            unsigned int alt = v[p++];
+            unsigned int n = v[p++];
+            Archive a;
+            for (unsigned int j = 0; j < n; j++)
+                a.put(v[p++]);
+            (void) s->status();
+            const Choice* c = s->choice(a);
+            if (keep) {
+                Edge e;
+                e.c = c;
+                e.s = (k % cd == 0) ? clone(s) : NULL;
+                e.alt = alt;
+                e.gen = 0;
+                path.push_back(e);
+            }
+            s->commit(*c, alt);
+            if (!keep)
+                delete c;
+        }
+        return s;
+    }
+
+    // Write a checkpoint for the current node
+    void checkpoint(void) {
+        std::string file(opt.checkpoint());
+        std::string tmp = file + ".tmp";
+        {
+            std::ofstream f(tmp.c_str());
+            f << "checkpoint " << solutions << ' ' << nodes << ' '
+              << failures << ' ' << propagations << ' ' << peak << '\n';
+            f << fails.size();
+            for (size_t d = 0; d < fails.size(); d++)
+                f << ' ' << fails[d];
+            f << '\n';
+            std::vector<unsigned int> v = archive();
+            f << v.size();
+            for (size_t i = 0; i < v.size(); i++)
+                f << ' ' << v[i];
+            f << '\n' << incumbent.size();
+            for (size_t i = 0; i < incumbent.size(); i++)
+                f << ' ' << incumbent[i];
+            f << '\n';
+        }
+        // Replace the previous checkpoint only once this one is complete
+        std::rename(tmp.c_str(), file.c_str());
+        saved = Clock::now();
+    }
+
+    // Restore path, incumbent and statistics from checkpoint file
+    void resume(const char* file) {
+        std::ifstream f(file);
+        std::string tag;
+        f >> tag;
+        if (!f || (tag != "checkpoint"))
+            throw Exception("Explorer::resume", "not a checkpoint file");
+        f >> solutions >> nodes >> failures >> propagations >> peak;
+        size_t n;
+        f >> n;
+        fails.resize(n);
+        for (size_t d = 0; d < n; d++)
+            f >> fails[d];
+        std::vector<unsigned int> frontier;
+        f >> n;
+        frontier.resize(n);
+        for (size_t i = 0; i < n; i++)
+            f >> frontier[i];
+        f >> n;
+        incumbent.resize(n);
+        for (size_t i = 0; i < n; i++)
+            f >> incumbent[i];
+        if (!f)
+            throw Exception("Explorer::resume", "truncated checkpoint file");
+
+        Space* root = cur;
+        (void) root->status();
+        if (!incumbent.empty()) {
+            size_t p = 0;
+            Space* s = replay(root->clone(), incumbent, p, false);
+            (void) s->status();
+            best = static_cast<S*>(s);
+            better(best);
+        }
+        size_t p = 0;
+        cur = replay(root->clone(), frontier, p, true);
+        delete root;
+        if (bab && (best != NULL))
+            cur->constrain(*best);
+    }
+
+    // Clone s, keeping track of the clone size
+    Space* clone(Space* s) {
+        Space* c = s->clone();
+        clone_bytes = std::max(clone_bytes, c->allocated());
+        clones++;
+        return c;
+    }
+
+    // Delete the clone of edge e
+    void drop(Edge& e) {
+        if (e.s != NULL) {
+            delete e.s;
+            e.s = NULL;
+            clones--;
+        }
+    }
+
+    /*
+     * Keep the clones within the memory budget: double the copy distance
+     * and drop the clones off it while they take too much, and halve it
+     * once per call (down to c_d) when they would fit twice over. Halving
+     * adds no clones by itself, only the nodes explored after it get
+     * them, so the estimate is only updated by later calls.
+     */
+    void budget(void) {
+        // The current node and the incumbent are spaces as well
+        size_t used = (clones + 2) * clone_bytes;
+        peak_memory = std::max(peak_memory, used);
+        if (opt.memory_budget() == 0)
+            return;
+        size_t limit = static_cast<size_t>(opt.memory_budget()) << 20;
+        while ((used > limit) && (cd < path.size())) {
+            cd *= 2;
+            peak_cd = std::max(peak_cd, cd);
+            // The clone at the root is always kept
+            for (size_t i = 1; i < path.size(); i++)
+                if (i % cd != 0)
+                    drop(path[i]);
+            used = (clones + 2) * clone_bytes;
+        }
+        if ((2 * used <= limit) && (cd / 2 >= opt.c_d()))
+            cd /= 2;
+    }
+
+    // Recompute the node below the last edge of the path
+    Space* recompute(void) {
+        int k = static_cast<int>(path.size()) - 1;
+        int i = k;
+        while (path[i].s == NULL)
+            i--;
+        Space* s;
+        /*
+         * Last alternative: the clone is not needed any longer. The one
+         * at the root is kept all the same: edges below it have no clone
+         * until depth c_d, and recomputing any of them looks upwards for
+         * the nearest clone. Without the root's it would search past the
+         * start of the path.
+         */
+        if ((i == k) && (k > 0) &&
+            (path[k].alt+1 == path[k].c->alternatives())) {
+            s = path[k].s; path[k].s = NULL;
+            clones--;
+        } else {
+            s = path[i].s->clone();
+        }
+        for (int j = i; j <= k; j++)
+            s->commit(*path[j].c, path[j].alt);
+        if (bab && (best != NULL) && (path[i].gen < solutions))
+            s->constrain(*best);
+        return s;
+    }
+
+    // Keep a copy of solution s if it has the best objective so far
+    void better(S* s) {
+        const Objective* o = dynamic_cast<const Objective*>(s);
+        if (o == NULL)
+            return;
+        int v = o->objective();
+        if ((top != NULL) && (minimising ? (v >= top_value) : (v <= top_value)))
+            return;
+        delete top;
+        top = static_cast<S*>(s->clone());
+        top_value = v;
+    }
+
+    /*
+     * Best bound over the open part of the tree: the current node and
+     * every alternative on the path still to be explored. Returns false
+     * if all of them fail, that is if the tree is exhausted.
+     *
+     * Only stable spaces can be cloned, so every node is propagated
+     * before it is cloned. A recomputed node that fails closes the rest
+     * of the path, which lies below it, and the current node with it.
+     */
+    bool proven(int& v) {
+        std::vector<Space*> open;
+        // s is the node before the choice of edge k
+        Space* s = NULL;
+        bool closed = false;
+        for (size_t k = 0; k < path.size(); k++) {
+            if (path[k].s != NULL) {
+                delete s;
+                s = path[k].s->clone();
+            } else {
+                s->commit(*path[k-1].c, path[k-1].alt);
+            }
+            if (s->status() == SS_FAILED) {
+                closed = true;
+                break;
+            }
+            for (unsigned int a = path[k].alt+1;
+                 a < path[k].c->alternatives(); a++) {
+                Space* c = s->clone();
+                c->commit(*path[k].c, a);
+                if (bab && (best != NULL))
+                    c->constrain(*best);
+                open.push_back(c);
+            }
+        }
+        delete s;
+        if ((cur != NULL) && !closed && (cur->status() != SS_FAILED))
+            open.push_back(cur->clone());
+        bool any = false;
+        for (size_t i = 0; i < open.size(); i++) {
+            if (open[i]->status() != SS_FAILED) {
+                int b = dynamic_cast<const Objective*>(open[i])->bound();
+                if (!any || (minimising ? (b < v) : (b > v)))
+                    v = b;
+                any = true;
+            }
+            delete open[i];
+        }
+        return any;
+    }
+
+    // Pop exhausted edges and move to the next alternative
+    bool backtrack(void) {
+        while (!path.empty() &&
+               (path.back().alt+1 >= path.back().c->alternatives())) {
+            drop(path.back());
+            delete path.back().c;
+            path.pop_back();
+        }
+        if (path.empty())
+            return false;
+        path.back().alt++;
+        cur = recompute();
+        return true;
+    }
+
+public:
+    Explorer(S* root, const EngineOptions& o, bool b)
+    : opt(o), bab(b), cur(root), best(NULL), top(NULL), top_value(0),
+      solutions(0), nodes(0), failures(0), propagations(0), peak(0),
+      cd(o.c_d()), peak_cd(o.c_d()), clone_bytes(0), clones(0),
+      peak_memory(0), expired(false), optimising(false),
+      minimising(false), known(false), known_value(0),
+      progress(NULL), started(Clock::now()), reported(started),
+      saved(started) {
+        if (opt.progress() != NULL) {
+            if (std::string(opt.progress()) == "stderr")
+                progress = &std::cerr;
+            else
+                progress = new std::ofstream(opt.progress());
+        }
+        const Objective* obj = dynamic_cast<const Objective*>(root);
+        if (obj != NULL) {
+            optimising = true;
+            minimising = obj->minimise();
+            known = obj->known(known_value);
+        }
+        if (opt.resume() != NULL)
+            resume(opt.resume());
+    }
+
+    // Return next solution (NULL if there is none), owned by the caller
+    S* next(void) {
+        while (true) {
+            if ((opt.deadline() > 0) && (ms(started) >= opt.deadline())) {
+                expired = true;
+                return NULL;
+            }
+            if ((cur == NULL) && !backtrack())
+                return NULL;
+            if ((opt.checkpoint() != NULL) &&
+                (ms(saved) >= opt.checkpoint_interval()))
+                checkpoint();
+            nodes++;
+            if ((progress != NULL) &&
+                (ms(reported) >= opt.progress_interval()))
+                report();
+            StatusStatistics ss;
+            SpaceStatus st = cur->status(ss);
+            propagations += ss.propagate;
+            if (st == SS_FAILED) {
+                failures++;
+                if (fails.size() <= path.size())
+                    fails.resize(path.size()+1, 0);
+                fails[path.size()]++;
+                delete cur; cur = NULL;
+            } else if (st == SS_SOLVED) {
+                S* s = static_cast<S*>(cur);
+                cur = NULL;
+                delete best;
+                best = static_cast<S*>(s->clone());
+                better(best);
+                incumbent = archive();
+                solutions++;
+                return s;
+            } else {
+                Edge e;
+                e.c = cur->choice();
+                e.s = (path.size() % cd == 0) ? clone(cur) : NULL;
+                e.alt = 0;
+                e.gen = solutions;
+                path.push_back(e);
+                budget();
+                if (path.size() > peak)
+                    peak = path.size();
+                cur->commit(*e.c, 0);
+            }
+        }
+    }
+
+    // Search and print like Script::run
+    void run(std::ostream& os) {
+        os << opt.name() << '\n';
+        if (opt.resume() != NULL) {
+            os << "Resumed from " << opt.resume() << '\n';
+            if (best != NULL)
+                best->print(os);
+        }
+        unsigned long int n = opt.solutions();
+        bool complete = true;
+        while (S* s = next()) {
+            s->print(os);
+            delete s;
+            if (solutions == n) {
+                complete = false;
+                break;
+            }
+        }
+        if (expired) {
+            complete = false;
+            os << "Deadline of " << opt.deadline() << " ms reached" << '\n';
+            if (best != NULL) {
+                os << "Incumbent" << '\n';
+                best->print(os);
+            }
+        }
+        // Nothing is left to resume once the tree is exhausted
+        if (complete && (opt.checkpoint() != NULL))
+            std::remove(opt.checkpoint());
+        if (progress != NULL)
+            report();
+        double t = ms(started);
+        os << '\n'
+           << "Summary" << '\n'
+           << "\truntime:      " << std::fixed << std::setprecision(3)
+           << t/1000.0 << " (" << t << " ms)" << '\n'
+           << "\tsolutions:    " << solutions << '\n'
+           << "\tpropagations: " << propagations << '\n'
+           << "\tnodes:        " << nodes << '\n'
+           << "\tfailures:     " << failures << '\n'
+           << "\tpeak depth:   " << peak << '\n'
+           << "\tclone size:   " << clone_bytes << " bytes" << '\n'
+           << "\tpeak memory:  " << (peak_memory >> 10) << " KB (estimated)"
+           << '\n'
+           << "\tcopy distance: " << opt.c_d() << " (up to " << peak_cd
+           << ")" << '\n';
+        if ((opt.deadline() > 0) && optimising)
+            gap(os, complete);
+        os << '\n';
+    }
+
+    /*
+     * Return the solution with the best objective if the search proved
+     * it optimal, that is if nothing open can beat it (NULL otherwise).
+     * The solution is owned by the caller.
+     */
+    S* optimum(void) {
+        if (top == NULL)
+            return NULL;
+        int b;
+        if (proven(b) && (minimising ? (b < top_value) : (b > top_value)))
+            return NULL;
+        return static_cast<S*>(top->clone());
+    }
+
+    // Report incumbent, proven bound and gap of an optimising script
+    void gap(std::ostream& os, bool complete) {
+        const Objective* o = dynamic_cast<const Objective*>(best);
+        bool has = (o != NULL) || known;
+        int inc = (o != NULL) ? o->objective() : known_value;
+        os << "\tincumbent:    ";
+        if (o != NULL)
+            os << inc << '\n';
+        else if (known)
+            os << inc << " (known before search)" << '\n';
+        else
+            os << "none" << '\n';
+        int b = 0;
+        if (complete || !proven(b)) {
+            // nothing open is left to improve on the incumbent
+            os << "\tbound:        " << (has ? "optimal" : "infeasible")
+               << '\n';
+            if (has)
+                os << "\tgap:          0" << '\n';
+            return;
+        }
+        os << "\tbound:        " << b << '\n';
+        if (has)
+            os << "\tgap:          "
+               << std::max(0, minimising ? inc-b : b-inc) << '\n';
+    }
+
+    ~Explorer(void) {
+        while (!path.empty()) {
+            delete path.back().s;
+            delete path.back().c;
+            path.pop_back();
+        }
+        delete cur;
+        delete best;
+        delete top;
+        if ((progress != NULL) && (progress != &std::cerr))
+            delete progress;
+    }
+};
+
+// Whether engine E optimises
+template<template<class> class E>
+struct Optimising {
+    static const bool value = false;
+};
+template<>
+struct Optimising<BAB> {
+    static const bool value = true;
+};
+
+// Run script S with engine E, using the explorer when options need it
+template<class S, template<class> class E, class Options>
+void solve(const Options& opt) {
+    Sink::install(std::cout, opt.sink());
+    if (!opt.explore()) {
+        Script::run<S,E,Options>(opt);
+        return;
+    }
+    Explorer<S> e(new S(opt), opt, Optimising<E>::value);
+    e.run(std::cout);
+}
+
+/*
+ * Run script S with engine E and return its best solution if the search
+ * proved it optimal (NULL otherwise), owned by the caller. The explorer
+ * is always used, as Script::run does not hand out its solutions.
+ */
+template<class S, template<class> class E, class Options>
+S* solveOptimal(const Options& opt) {
+    Sink::install(std::cout, opt.sink());
+    Explorer<S> e(new S(opt), opt, Optimising<E>::value);
+    e.run(std::cout);
+    return e.optimum();
+}
+
+#endif
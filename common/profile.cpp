@@ -0,0 +1,131 @@
+/*
+ * Opt-in profiling of custom propagators and branchers.
+ *
+ * Compile with -DPROFILE_ACTORS to make every actor that labels itself
+ * with PROFILE_SCOPE count its calls, prunings, failures and the time
+ * spent inside it. Everything below compiles away without the flag.
+ *
+ * The built-in propagators (dom, linear, rel, ...) cannot be labelled,
+ * so the report lists the remaining run time as unlabelled.
+ */
+
+#ifndef COMMON_PROFILE
+#define COMMON_PROFILE
+
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+#include <chrono>
+
+namespace Profile {
+
+#ifdef PROFILE_ACTORS
+
+    typedef std::chrono::steady_clock Clock;
+
+    // Counters for one label, kept in a global list
+    class Counter {
+    public:
+        const char* label;
+        unsigned long int calls;
+        unsigned long int prunings;
+        unsigned long int failures;
+        unsigned long long int ns;
+        Counter* next;
+
+        Counter(const char* l, Counter* n)
+        : label(l), calls(0), prunings(0), failures(0), ns(0), next(n) {}
+    };
+
+    // Head of the list of counters
+    static Counter* counters = NULL;
+    // Start of the profiled run
+    static Clock::time_point started = Clock::now();
+
+    // Return the counter for label l, creating it on first use
+    inline Counter& counter(const char* l) {
+        for (Counter* c = counters; c != NULL; c = c->next)
+            if (std::strcmp(c->label, l) == 0)
+                return *c;
+        counters = new Counter(l, counters);
+        return *counters;
+    }
+
+    // Measures one call of an actor from construction to destruction
+    class Scope {
+    protected:
+        Counter& c;
+        Clock::time_point t;
+        unsigned long int m;
+    public:
+        Scope(Counter& c0) : c(c0), t(Clock::now()), m(0) {
+            c.calls++;
+        }
+        // Remember the total domain size n on entry
+        void mark(unsigned long int n) {
+            m = n;
+        }
+        // Count a pruning if the total domain size n shrank since mark
+        void pruned(unsigned long int n) {
+            if (n < m)
+                c.prunings++;
+        }
+        // Record that the call failed
+        void failed(void) {
+            c.failures++;
+        }
+        ~Scope(void) {
+            c.ns += std::chrono::duration_cast<std::chrono::nanoseconds>
+                (Clock::now() - t).count();
+        }
+    };
+
+    // Restart the clock the report measures the run time with
+    inline void start(void) {
+        started = Clock::now();
+    }
+
+    // Print one line per label and the unlabelled remainder
+    inline void print(std::ostream& os) {
+        double total = std::chrono::duration_cast<std::chrono::nanoseconds>
+            (Clock::now() - started).count() / 1e6;
+        double labelled = 0.0;
+        os << "Actor profile" << '\n';
+        for (Counter* c = counters; c != NULL; c = c->next) {
+            double ms = c->ns / 1e6;
+            labelled += ms;
+            os << "\t" << std::left << std::setw(30) << c->label << std::right
+               << " calls: " << std::setw(10) << c->calls
+               << " prunings: " << std::setw(10) << c->prunings
+               << " failures: " << std::setw(10) << c->failures
+               << " time: " << std::fixed << std::setprecision(3)
+               << ms << " ms" << '\n';
+        }
+        os << "\t" << std::left << std::setw(30) << "unlabelled" << std::right
+           << " time: " << std::fixed << std::setprecision(3)
+           << (total - labelled) << " ms" << '\n';
+        os << std::endl;
+    }
+
+#define PROFILE_SCOPE(v,l) \
+    static Profile::Counter& v##_counter = Profile::counter(l); \
+    Profile::Scope v(v##_counter)
+#define PROFILE_MARK(v,n) v.mark(n)
+#define PROFILE_PRUNED(v,n) v.pruned(n)
+#define PROFILE_FAILED(v) v.failed()
+
+#else
+
+    inline void start(void) {}
+    inline void print(std::ostream&) {}
+
+#define PROFILE_SCOPE(v,l)
+#define PROFILE_MARK(v,n)
+#define PROFILE_PRUNED(v,n)
+#define PROFILE_FAILED(v)
+
+#endif
+
+}
+
+#endif
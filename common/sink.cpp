@@ -0,0 +1,179 @@
+/*
+ * Buffered output of solutions.
+ *
+ * Enumerating many solutions spends much of its time flushing: every
+ * std::endl in a print() and in the driver forces a write. With -sink
+ * text or -sink compact, std::cout writes into a large buffer that is
+ * only written out when full or at the end, and flush requests are
+ * ignored. Compact scripts print each solution as one line of values
+ * instead of the formatted board.
+ *
+ * The sink keeps count of the bytes written and of the time spent in
+ * print() and in writing, so output cost can be told apart from the
+ * search time in the summary.
+ *
+ * Scripts add a SinkOption to their options and call install() once all
+ * input has been read. The buffer is written out and the output cost
+ * reported when the program exits.
+ */
+
+#ifndef COMMON_SINK
+#define COMMON_SINK
+
+#include <gecode/driver.hh>
+#include <iostream>
+#include <iomanip>
+#include <streambuf>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+
+namespace Sink {
+
+    typedef std::chrono::steady_clock Clock;
+
+    // How solutions are written
+    enum {
+        STREAM,     // straight to the stream, flushing as asked
+        TEXT,       // formatted, buffered
+        COMPACT     // one line per solution, buffered
+    };
+
+    // Buffer in front of another stream buffer
+    class Buffer : public std::streambuf {
+    protected:
+        // Where the output goes
+        std::streambuf* out;
+        // The buffer
+        std::vector<char> buf;
+    public:
+        // Bytes written
+        unsigned long long int bytes;
+        // Nanoseconds spent writing
+        unsigned long long int ns;
+
+        Buffer(std::streambuf* o, size_t size)
+        : out(o), buf(size), bytes(0), ns(0) {
+            setp(&buf[0], &buf[0] + buf.size());
+        }
+        // Write out what is buffered
+        void drain(void) {
+            std::streamsize n = pptr() - pbase();
+            if (n > 0) {
+                Clock::time_point t = Clock::now();
+                out->sputn(pbase(), n);
+                out->pubsync();
+                ns += std::chrono::duration_cast<std::chrono::nanoseconds>
+                    (Clock::now() - t).count();
+                bytes += n;
+            }
+            setp(&buf[0], &buf[0] + buf.size());
+        }
+    protected:
+        virtual int_type overflow(int_type c) {
+            drain();
+            if (!traits_type::eq_int_type(c, traits_type::eof()))
+                sputc(traits_type::to_char_type(c));
+            return traits_type::not_eof(c);
+        }
+        // Flush requests are ignored, the buffer drains when full
+        virtual int sync(void) {
+            return 0;
+        }
+    };
+
+    // The installed sink
+    class State {
+    public:
+        int format;
+        Buffer* buffer;
+        std::ostream* os;
+        std::streambuf* old;
+        // Nanoseconds spent in print()
+        unsigned long long int ns;
+        State(void) : format(STREAM), buffer(NULL), os(NULL), old(NULL),
+                      ns(0) {}
+    };
+
+    inline State& state(void) {
+        static State s;
+        return s;
+    }
+
+    // Whether solutions are printed as one line
+    inline bool compact(void) {
+        return state().format == COMPACT;
+    }
+
+    // Measures one print() from construction to destruction
+    class Timer {
+    protected:
+        Clock::time_point t;
+    public:
+        Timer(void) : t(Clock::now()) {}
+        ~Timer(void) {
+            state().ns += std::chrono::duration_cast<std::chrono::nanoseconds>
+                (Clock::now() - t).count();
+        }
+    };
+
+    // Print the values of x as one line, separated by sep (if not 0)
+    template<class A>
+    void line(std::ostream& os, const A& x, char sep = ' ') {
+        for (int i = 0; i < x.size(); i++) {
+            if ((i > 0) && (sep != 0))
+                os << sep;
+            if (x[i].assigned())
+                os << x[i].val();
+            else
+                os << '_';
+        }
+        os << '\n';
+    }
+
+    // Write out the buffer, restore the stream and report the output cost
+    inline void finish(void) {
+        State& s = state();
+        if (s.buffer == NULL)
+            return;
+        s.buffer->drain();
+        s.os->rdbuf(s.old);
+        *s.os << "Output" << '\n'
+              << "\tbytes:        " << s.buffer->bytes << '\n'
+              << "\tprint time:   " << std::fixed << std::setprecision(3)
+              << s.ns / 1e6 << " ms" << '\n'
+              << "\twrite time:   " << s.buffer->ns / 1e6 << " ms" << '\n';
+        s.os->flush();
+        delete s.buffer;
+        s.buffer = NULL;
+    }
+
+    // Put a buffer of size bytes in front of os, unless format is STREAM
+    inline void install(std::ostream& os, int format, size_t size = 1 << 16) {
+        State& s = state();
+        s.format = format;
+        if ((format == STREAM) || (s.buffer != NULL))
+            return;
+        os.flush();
+        s.os = &os;
+        s.old = os.rdbuf();
+        s.buffer = new Buffer(s.old, size);
+        os.rdbuf(s.buffer);
+        std::atexit(finish);
+    }
+
+}
+
+// Option selecting how solutions are written
+class SinkOption : public Gecode::Driver::StringOption {
+public:
+    SinkOption(void)
+    : Gecode::Driver::StringOption("-sink", "how to write solutions",
+                                   Sink::STREAM) {
+        add(Sink::STREAM, "stream", "write and flush as printed");
+        add(Sink::TEXT, "text", "buffer formatted solutions");
+        add(Sink::COMPACT, "compact", "buffer one line per solution");
+    }
+};
+
+#endif